@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "base64.h"
+
+namespace {
+
+// Попередній base64Encode() з websocket_server.cpp: по символу в std::string
+std::string legacyEncode(const unsigned char* data, size_t len) {
+    static const char tbl[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((len + 2) / 3 * 4);
+    for (size_t i = 0; i < len; i += 3) {
+        unsigned int n = data[i] << 16;
+        if (i + 1 < len) n |= data[i + 1] << 8;
+        if (i + 2 < len) n |= data[i + 2];
+        out += tbl[(n >> 18) & 63];
+        out += tbl[(n >> 12) & 63];
+        out += (i + 1 < len) ? tbl[(n >> 6) & 63] : '=';
+        out += (i + 2 < len) ? tbl[n & 63] : '=';
+    }
+    return out;
+}
+
+std::vector<uint8_t> makeData(size_t len) {
+    std::vector<uint8_t> data(len);
+    for (size_t i = 0; i < len; i++)
+        data[i] = static_cast<uint8_t>(i * 131 + 7);
+    return data;
+}
+
+// Кратне 3, тож закодований текст без padding — саме те, що приймають ядра декодування
+size_t roundDown3(int64_t n) {
+    return static_cast<size_t>(n) / 3 * 3;
+}
+
+bool supported(benchmark::State& state, bool ok, const char* what) {
+    if (!ok) state.SkipWithError(what);
+    return ok;
+}
+
+void BM_EncodeLegacy(benchmark::State& state) {
+    std::vector<uint8_t> data = makeData(roundDown3(state.range(0)));
+    for (auto _ : state) {
+        std::string out = legacyEncode(data.data(), data.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+template <base64::detail::EncodeFn Fn>
+void BM_Encode(benchmark::State& state) {
+    std::vector<uint8_t> data = makeData(roundDown3(state.range(0)));
+    std::vector<char> out(base64::encodedSize(data.size()));
+    for (auto _ : state) {
+        Fn(data.data(), data.size(), out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+template <base64::detail::DecodeFn Fn>
+void BM_Decode(benchmark::State& state) {
+    std::vector<uint8_t> data = makeData(roundDown3(state.range(0)));
+    std::vector<char> text(base64::encodedSize(data.size()));
+    base64::detail::encodeScalar(data.data(), data.size(), text.data());
+    std::vector<uint8_t> out(data.size());
+    for (auto _ : state) {
+        bool ok = Fn(text.data(), text.size(), out.data());
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+void BM_EncodeDispatch(benchmark::State& state) {
+    std::vector<uint8_t> data = makeData(roundDown3(state.range(0)));
+    std::vector<char> out(base64::encodedSize(data.size()));
+    state.SetLabel(base64::backendName());
+    for (auto _ : state) {
+        base64::encode(data.data(), data.size(), out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+void BM_DecodeDispatch(benchmark::State& state) {
+    std::vector<uint8_t> data = makeData(roundDown3(state.range(0)));
+    std::vector<char> text(base64::encodedSize(data.size()));
+    base64::encode(data.data(), data.size(), text.data());
+    std::vector<uint8_t> out(base64::maxDecodedSize(text.size()));
+    state.SetLabel(base64::backendName());
+    for (auto _ : state) {
+        size_t n = 0;
+        bool ok = base64::decode(text.data(), text.size(), out.data(), n);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+#if defined(BASE64_X86)
+void BM_EncodeSsse3(benchmark::State& state) {
+    if (supported(state, base64::detail::cpuHasSsse3(), "SSSE3 недоступний"))
+        BM_Encode<base64::detail::encodeSsse3>(state);
+}
+
+void BM_EncodeAvx2(benchmark::State& state) {
+    if (supported(state, base64::detail::cpuHasAvx2(), "AVX2 недоступний"))
+        BM_Encode<base64::detail::encodeAvx2>(state);
+}
+
+void BM_DecodeSsse3(benchmark::State& state) {
+    if (supported(state, base64::detail::cpuHasSsse3(), "SSSE3 недоступний"))
+        BM_Decode<base64::detail::decodeSsse3>(state);
+}
+
+void BM_DecodeAvx2(benchmark::State& state) {
+    if (supported(state, base64::detail::cpuHasAvx2(), "AVX2 недоступний"))
+        BM_Decode<base64::detail::decodeAvx2>(state);
+}
+#endif
+
+// 20 байтів — SHA1 у Sec-WebSocket-Accept; далі буфер обміну і файли
+void sizes(benchmark::internal::Benchmark* b) {
+    b->Arg(20)->Arg(4 << 10)->Arg(1 << 20);
+}
+
+} // namespace
+
+BENCHMARK(BM_EncodeLegacy)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_Encode, base64::detail::encodeScalar)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_Decode, base64::detail::decodeScalar)->Apply(sizes);
+#if defined(BASE64_X86)
+BENCHMARK(BM_EncodeSsse3)->Apply(sizes);
+BENCHMARK(BM_EncodeAvx2)->Apply(sizes);
+BENCHMARK(BM_DecodeSsse3)->Apply(sizes);
+BENCHMARK(BM_DecodeAvx2)->Apply(sizes);
+#endif
+BENCHMARK(BM_EncodeDispatch)->Apply(sizes);
+BENCHMARK(BM_DecodeDispatch)->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+#include <zlib.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "ws_deflate.h"
+
+namespace {
+
+enum Payload { Stats, Json, Random };
+
+// Те, що сервер справді відправляє: рядок "stats", JSON-подібні пакети і
+// вже стиснені (випадкові) дані, на яких deflate лише витрачає CPU
+std::string makePayload(int kind, size_t size) {
+    std::string out;
+    char buf[160];
+    unsigned seed = 12345;
+    while (out.size() < size) {
+        int n = 0;
+        seed = seed * 1103515245u + 12345u;
+        if (kind == Stats) {
+            n = snprintf(buf, sizeof(buf), "stage=%u count=%u p50=%uus p99=%uus max=%uus; ",
+                         seed % 5, seed % 10000, seed % 90 + 10, seed % 900 + 100, seed % 5000);
+        } else if (kind == Json) {
+            n = snprintf(buf, sizeof(buf), "{\"key\":\"f%u\",\"repeat\":%u,\"modifiers\":[\"ctrl\",\"shift\"]},",
+                         seed % 12 + 1, seed % 4);
+        } else {
+            for (int i = 0; i < 64; i++) {
+                seed = seed * 1103515245u + 12345u;
+                buf[i] = static_cast<char>(seed >> 24);
+            }
+            n = 64;
+        }
+        out.append(buf, static_cast<size_t>(n));
+    }
+    out.resize(size);
+    return out;
+}
+
+const char* payloadName(int kind) {
+    return kind == Stats ? "stats" : kind == Json ? "json" : "random";
+}
+
+// range(0) — тип даних, range(1) — розмір, range(2) — server_max_window_bits,
+// range(3) — 1, якщо server_no_context_takeover
+void BM_Compress(benchmark::State& state) {
+    std::string data = makePayload(static_cast<int>(state.range(0)), static_cast<size_t>(state.range(1)));
+    ws::DeflateParams params;
+    params.serverMaxWindowBits = static_cast<int>(state.range(2));
+    params.serverNoContextTakeover = state.range(3) != 0;
+    ws::DeflateConfig config;
+    ws::DeflatePool pool(config.level, config.memLevel);
+    ws::DeflateSession session(params, pool, config.threshold);
+
+    std::string out;
+    int64_t wireBytes = 0;
+    for (auto _ : state) {
+        // Не вийшло стиснути — кадр іде як є
+        wireBytes += session.compress(data.data(), data.size(), out) ? out.size() : data.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    int64_t rawBytes = state.iterations() * static_cast<int64_t>(data.size());
+    state.SetBytesProcessed(rawBytes);
+    state.counters["ratio"] = rawBytes ? static_cast<double>(wireBytes) / rawBytes : 0;
+    state.counters["saved/msg"] = state.iterations() ? static_cast<double>(rawBytes - wireBytes) / state.iterations() : 0;
+    state.SetLabel(payloadName(static_cast<int>(state.range(0))));
+}
+
+// Без пулу: deflateInit2/deflateEnd на кожне повідомлення
+void BM_CompressFreshStream(benchmark::State& state) {
+    std::string data = makePayload(static_cast<int>(state.range(0)), static_cast<size_t>(state.range(1)));
+    int windowBits = static_cast<int>(state.range(2));
+    ws::DeflateConfig config;
+    std::string out(data.size() + 64, '\0');
+    for (auto _ : state) {
+        z_stream z = {};
+        deflateInit2(&z, config.level, Z_DEFLATED, -windowBits, config.memLevel, Z_DEFAULT_STRATEGY);
+        z.next_in = reinterpret_cast<Bytef*>(&data[0]);
+        z.avail_in = static_cast<uInt>(data.size());
+        z.next_out = reinterpret_cast<Bytef*>(&out[0]);
+        z.avail_out = static_cast<uInt>(out.size());
+        deflate(&z, Z_SYNC_FLUSH);
+        deflateEnd(&z);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+    state.SetLabel(payloadName(static_cast<int>(state.range(0))));
+}
+
+// Розпакування повідомлення клієнта (client_no_context_takeover, як просить сервер)
+void BM_Decompress(benchmark::State& state) {
+    std::string data = makePayload(static_cast<int>(state.range(0)), static_cast<size_t>(state.range(1)));
+    ws::DeflateParams params;
+    params.serverMaxWindowBits = params.clientMaxWindowBits = static_cast<int>(state.range(2));
+    params.serverNoContextTakeover = params.clientNoContextTakeover = true;
+    ws::DeflateConfig config;
+    ws::DeflatePool pool(config.level, config.memLevel);
+    ws::DeflateSession session(params, pool, config.threshold);
+
+    std::string packed;
+    if (!session.compress(data.data(), data.size(), packed)) {
+        state.SkipWithError("дані не стискаються");
+        return;
+    }
+    std::vector<uint8_t> out(data.size());
+    for (auto _ : state) {
+        size_t n = 0;
+        session.decompress(reinterpret_cast<const uint8_t*>(packed.data()), packed.size(), out.data(), out.size(), n);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+    state.SetLabel(payloadName(static_cast<int>(state.range(0))));
+}
+
+} // namespace
+
+BENCHMARK(BM_Compress)
+    ->ArgNames({"data", "size", "bits", "no_takeover"})
+    ->ArgsProduct({{Stats, Json, Random}, {256, 4096}, {9, 13, 15}, {0, 1}});
+BENCHMARK(BM_CompressFreshStream)
+    ->ArgNames({"data", "size", "bits"})
+    ->ArgsProduct({{Stats, Json}, {256, 4096}, {13, 15}});
+BENCHMARK(BM_Decompress)
+    ->ArgNames({"data", "size", "bits"})
+    ->ArgsProduct({{Stats, Json}, {256, 4096}, {13, 15}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,262 @@
+#include <benchmark/benchmark.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "command_protocol.h"
+#include "keyboard_simulator.h"
+#include "latency_stats.h"
+#include "recording_backend.h"
+#include "websocket_server.h"
+
+// Увесь конвеєр сервера без дисплея: клієнт на loopback → WebSocketServer →
+// розбір бінарних команд → черга → потік ін'єкції → RecordingBackend.
+// BM_TapThroughput — натискань за секунду при різній кількості записів
+// у повідомленні; BM_TapLatency — від send() клієнта до flush() бекенду
+// (час ітерації — саме ця затримка); BM_PointerMoves — скільки подій руху
+// доходить до бекенду на одне повідомлення при різному тіку вказівника.
+
+namespace {
+
+const uint16_t kPort = 18767;
+const auto kWaitLimit = std::chrono::seconds(2);
+
+int connectClient() {
+    for (int attempt = 0; attempt < 200; attempt++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(kPort);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return -1;
+}
+
+bool upgrade(int fd) {
+    static const char kRequest[] =
+        "GET / HTTP/1.1\r\nHost: bench\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    if (send(fd, kRequest, sizeof(kRequest) - 1, 0) != static_cast<ssize_t>(sizeof(kRequest) - 1)) return false;
+    std::string head;
+    char c;
+    while (head.size() < 4 || head.compare(head.size() - 4, 4, "\r\n\r\n") != 0) {
+        if (recv(fd, &c, 1, 0) != 1) return false;
+        head += c;
+    }
+    return head.compare(0, 12, "HTTP/1.1 101") == 0;
+}
+
+// Маскований бінарний кадр з records записами протоколу команд
+std::string commandFrame(uint8_t op, uint16_t key, uint16_t repeat, size_t records) {
+    size_t size = records * proto::kRecordSize;
+    std::string frame;
+    frame += static_cast<char>(0x82);
+    if (size < 126) {
+        frame += static_cast<char>(0x80 | size);
+    } else {
+        frame += static_cast<char>(0x80 | 126);
+        frame += static_cast<char>(size >> 8);
+        frame += static_cast<char>(size & 0xFF);
+    }
+    const uint8_t mask[4] = {0x11, 0x22, 0x33, 0x44};
+    frame.append(reinterpret_cast<const char*>(mask), 4);
+    uint8_t record[proto::kRecordSize] = {op, 0, static_cast<uint8_t>(key), static_cast<uint8_t>(key >> 8),
+                                          static_cast<uint8_t>(repeat), static_cast<uint8_t>(repeat >> 8)};
+    for (size_t i = 0; i < size; i++)
+        frame += static_cast<char>(record[i % proto::kRecordSize] ^ mask[i % 4]);
+    return frame;
+}
+
+// Сервер з тим самим шляхом команди, що й у main.cpp (OpKeyTap, OpPointerMove)
+class Pipeline {
+public:
+    explicit Pipeline(std::chrono::microseconds pointerTick = std::chrono::milliseconds(8)) {
+        std::unique_ptr<RecordingBackend> backend(new RecordingBackend());
+        recorder_ = backend.get();
+        KeyboardSimulator::setBackend(std::move(backend));
+        KeyboardSimulator::setPointerTick(pointerTick);
+        // Вимірюємо пропускну здатність без втрат: клієнт чекає на місце в черзі
+        KeyboardSimulator::setBackpressureTimeout(std::chrono::milliseconds(100));
+        started_ = KeyboardSimulator::start(KeyboardSimulator::kDefaultQueueCapacity, OverflowPolicy::Backpressure);
+
+        server_.setCompression(false);
+        server_.setBinaryCallback([](const uint8_t* data, size_t size) {
+            latency::current().dispatched = latency::now();
+            for (size_t off = 0; off + proto::kRecordSize <= size; off += proto::kRecordSize) {
+                proto::Command cmd = proto::decode(data + off);
+                KeyCommand kc;
+                kc.key = cmd.key;
+                kc.repeat = cmd.repeat;
+                kc.modifiers = cmd.modifiers;
+                if (cmd.op == proto::OpPointerMove) {
+                    kc.key = 0;
+                    kc.action = KeyAction::PointerMove;
+                    kc.x = proto::toSigned(cmd.key);
+                    kc.y = proto::toSigned(cmd.repeat);
+                } else if (cmd.op != proto::OpKeyTap) {
+                    continue;
+                }
+                kc.timing = latency::current();
+                KeyboardSimulator::enqueue(kc);
+            }
+        });
+        if (started_) server_.start();
+    }
+
+    ~Pipeline() {
+        if (fd_ >= 0) close(fd_);
+        server_.stop();
+        KeyboardSimulator::stop();
+    }
+
+    bool connect() {
+        if (!started_) return false;
+        fd_ = connectClient();
+        return fd_ >= 0 && upgrade(fd_);
+    }
+
+    bool send(const std::string& frame) {
+        return ::send(fd_, frame.data(), frame.size(), 0) == static_cast<ssize_t>(frame.size());
+    }
+
+    // Чекає, поки бекенд отримає count подій type (рахуючи від попереднього
+    // виклику); last — остання з них. false, якщо не дочекалися.
+    bool waitFor(RecordedEvent::Type type, uint64_t count, RecordedEvent* last = nullptr) {
+        auto deadline = std::chrono::steady_clock::now() + kWaitLimit;
+        RecordedEvent ev;
+        while (count > 0) {
+            if (next_ == recorder_->recorded()) {
+                if (std::chrono::steady_clock::now() > deadline) return false;
+                idle();
+                continue;
+            }
+            if (!recorder_->event(next_++, ev)) return false;
+            if (ev.type != type) continue;
+            count--;
+            if (last) *last = ev;
+        }
+        return true;
+    }
+
+    // Сума зсувів усіх подій руху, що надійшли від попереднього виклику
+    bool waitForMotion(int64_t dx, uint64_t& events) {
+        auto deadline = std::chrono::steady_clock::now() + kWaitLimit;
+        RecordedEvent ev;
+        events = 0;
+        while (dx > 0) {
+            if (next_ == recorder_->recorded()) {
+                if (std::chrono::steady_clock::now() > deadline) return false;
+                idle();
+                continue;
+            }
+            if (!recorder_->event(next_++, ev)) return false;
+            if (ev.type != RecordedEvent::Move) continue;
+            dx -= ev.x;
+            events++;
+        }
+        return true;
+    }
+
+private:
+    // Не yield(): на одному ядрі опитування відбирало б час у потоків сервера.
+    // Затримка береться з міток бекенду, тож сон її не спотворює.
+    static void idle() { std::this_thread::sleep_for(std::chrono::microseconds(20)); }
+
+    WebSocketServer server_{kPort};
+    RecordingBackend* recorder_ = nullptr;
+    uint64_t next_ = 0;
+    bool started_ = false;
+    int fd_ = -1;
+};
+
+// range(0) — записів (натискань) в одному повідомленні
+void BM_TapThroughput(benchmark::State& state) {
+    const int kMessages = 64;
+    size_t records = static_cast<size_t>(state.range(0));
+    Pipeline pipeline;
+    if (!pipeline.connect()) {
+        state.SkipWithError("не вдалося запустити сервер");
+        return;
+    }
+    std::string frame = commandFrame(proto::OpKeyTap, keys::KeyRight, 1, records);
+    for (auto _ : state) {
+        for (int i = 0; i < kMessages; i++) pipeline.send(frame);
+        if (!pipeline.waitFor(RecordedEvent::KeyDown, kMessages * records)) {
+            state.SkipWithError("бекенд не отримав усіх натискань");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kMessages * static_cast<int64_t>(records));
+}
+
+void BM_TapLatency(benchmark::State& state) {
+    Pipeline pipeline;
+    if (!pipeline.connect()) {
+        state.SkipWithError("не вдалося запустити сервер");
+        return;
+    }
+    std::string frame = commandFrame(proto::OpKeyTap, keys::KeyRight, 1, 1);
+    std::vector<uint64_t> samples;
+    for (auto _ : state) {
+        uint64_t sent = latency::now();
+        pipeline.send(frame);
+        RecordedEvent flushed;
+        if (!pipeline.waitFor(RecordedEvent::KeyDown, 1) || !pipeline.waitFor(RecordedEvent::Flush, 1, &flushed)) {
+            state.SkipWithError("бекенд не отримав натискання");
+            break;
+        }
+        uint64_t ns = flushed.timeNs - sent;
+        samples.push_back(ns);
+        state.SetIterationTime(static_cast<double>(ns) / 1e9);
+    }
+    if (samples.empty()) return;
+    std::sort(samples.begin(), samples.end());
+    state.counters["p50_us"] = static_cast<double>(samples[samples.size() / 2]) / 1000.0;
+    state.counters["p99_us"] = static_cast<double>(samples[samples.size() * 99 / 100]) / 1000.0;
+}
+
+// range(0) — тік вказівника в мс; 256 повідомлень по 1 пікселю за ітерацію
+void BM_PointerMoves(benchmark::State& state) {
+    const int kMessages = 256;
+    Pipeline pipeline(std::chrono::milliseconds(state.range(0)));
+    if (!pipeline.connect()) {
+        state.SkipWithError("не вдалося запустити сервер");
+        return;
+    }
+    std::string frame = commandFrame(proto::OpPointerMove, 1, 0, 1);
+    uint64_t events = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < kMessages; i++) pipeline.send(frame);
+        uint64_t n;
+        if (!pipeline.waitForMotion(kMessages, n)) {
+            state.SkipWithError("бекенд не отримав усього руху");
+            break;
+        }
+        events += n;
+    }
+    state.SetItemsProcessed(state.iterations() * kMessages);
+    if (state.iterations() > 0)
+        state.counters["events/msg"] = static_cast<double>(events) / (state.iterations() * kMessages);
+}
+
+} // namespace
+
+BENCHMARK(BM_TapThroughput)->ArgName("records")->Arg(1)->Arg(16)->UseRealTime();
+BENCHMARK(BM_TapLatency)->UseManualTime();
+BENCHMARK(BM_PointerMoves)->ArgName("tick_ms")->Arg(0)->Arg(8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "input_backend.h"
+#include "key_table.h"
+#include "keyboard_simulator.h"
+
+// Швидкість ін'єкції через справжній X-сервер, наприклад Xvfb:
+//   xvfb-run -a ./inject_bench
+// BM_TapsBatched — серія натискань "right" однією послідовністю (один XFlush),
+// BM_TapsOneByOne — те саме, але кожне натискання окремою послідовністю
+// з очікуванням, тобто з власним XFlush.
+
+namespace {
+
+bool startInjector(benchmark::State& state) {
+    KeyboardSimulator::setBackend(createPlatformInputBackend());
+    if (KeyboardSimulator::start()) return true;
+    state.SkipWithError("немає дисплея (запустіть під xvfb-run)");
+    return false;
+}
+
+std::vector<KeyStep> taps(int count) {
+    std::vector<KeyStep> steps;
+    for (int i = 0; i < count; i++) {
+        steps.push_back(KeyStep::press(keys::KeyRight));
+        steps.push_back(KeyStep::release(keys::KeyRight));
+    }
+    return steps;
+}
+
+void BM_TapsBatched(benchmark::State& state) {
+    if (!startInjector(state)) return;
+    int count = static_cast<int>(state.range(0));
+    std::vector<KeyStep> steps = taps(count);
+    for (auto _ : state) {
+        KeyboardSimulator::injectSequence(steps.data(), steps.size());
+        KeyboardSimulator::waitForSequences();
+    }
+    KeyboardSimulator::stop();
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_TapsOneByOne(benchmark::State& state) {
+    if (!startInjector(state)) return;
+    int count = static_cast<int>(state.range(0));
+    std::vector<KeyStep> steps = taps(1);
+    for (auto _ : state) {
+        for (int i = 0; i < count; i++) {
+            KeyboardSimulator::injectSequence(steps.data(), steps.size());
+            KeyboardSimulator::waitForSequences();
+        }
+    }
+    KeyboardSimulator::stop();
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+} // namespace
+
+BENCHMARK(BM_TapsBatched)->ArgName("taps")->Arg(1)->Arg(20)->Arg(100)->UseRealTime();
+BENCHMARK(BM_TapsOneByOne)->ArgName("taps")->Arg(1)->Arg(20)->Arg(100)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,209 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "base64.h"
+#include "command_protocol.h"
+#include "key_table.h"
+#include "logger.h"
+#include "remote_control_server.h"
+#include "sha1.h"
+#include "websocket_server.h"
+#include "ws_frame_parser.h"
+
+// Гарячі шляхи сервера одним набором, щоб порівнювати коміти між собою:
+// розбір кадрів, ключ рукостискання, SHA1 і base64, розбір команд
+// RemoteControlServer і Logger::log(). Без --benchmark_out результати
+// пишуться ще й у remotecontrol_bench.json; порівняння двох прогонів —
+// tools/compare.py benchmarks old.json new.json з Google Benchmark.
+
+namespace {
+
+const uint16_t kPort = 18768;
+const char kDefaultOut[] = "--benchmark_out=remotecontrol_bench.json";
+
+// Маскований кадр від клієнта (payload до 64 КіБ)
+std::string clientFrame(uint8_t opcode, const std::string& payload) {
+    std::string frame;
+    frame += static_cast<char>(0x80 | opcode);
+    if (payload.size() < 126) {
+        frame += static_cast<char>(0x80 | payload.size());
+    } else {
+        frame += static_cast<char>(0x80 | 126);
+        frame += static_cast<char>(payload.size() >> 8);
+        frame += static_cast<char>(payload.size() & 0xFF);
+    }
+    const uint8_t mask[4] = {0x37, 0xfa, 0x21, 0x3d};
+    frame.append(reinterpret_cast<const char*>(mask), 4);
+    for (size_t i = 0; i < payload.size(); i++)
+        frame += static_cast<char>(payload[i] ^ mask[i % 4]);
+    return frame;
+}
+
+// records однакових записів протоколу команд
+std::string commandRecords(uint8_t op, uint16_t key, uint16_t repeat, size_t records) {
+    const uint8_t record[proto::kRecordSize] = {op, 0, static_cast<uint8_t>(key), static_cast<uint8_t>(key >> 8),
+                                                static_cast<uint8_t>(repeat), static_cast<uint8_t>(repeat >> 8)};
+    std::string data;
+    for (size_t i = 0; i < records; i++) data.append(reinterpret_cast<const char*>(record), sizeof(record));
+    return data;
+}
+
+void feed(ws::RingBuffer& input, const std::string& bytes) {
+    size_t done = 0;
+    while (done < bytes.size()) {
+        size_t contiguous = 0;
+        uint8_t* dst = input.writePtr(contiguous);
+        size_t n = std::min(contiguous, bytes.size() - done);
+        std::memcpy(dst, bytes.data() + done, n);
+        input.commit(n);
+        done += n;
+    }
+}
+
+// decodeWebSocketFrame() без з'єднання: кадри, що злиплися в кільцевому
+// буфері, розбираються FrameParser до NeedMore. range(0) — розмір payload.
+void BM_DecodeWebSocketFrame(benchmark::State& state) {
+    std::string frame = clientFrame(ws::OpBinary, std::string(static_cast<size_t>(state.range(0)), 'k'));
+    ws::FrameParser parser;
+    const size_t frames = std::max<size_t>(1, parser.input().capacity() / frame.size());
+    std::string batch;
+    for (size_t i = 0; i < frames; i++) batch += frame;
+    ws::FrameParser::Message msg;
+    for (auto _ : state) {
+        feed(parser.input(), batch);
+        size_t decoded = 0;
+        while (parser.next(msg) == ws::FrameParser::Status::Message) {
+            benchmark::DoNotOptimize(msg.data);
+            decoded++;
+        }
+        if (decoded != frames) {
+            state.SkipWithError("розібрано не всі кадри");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(frames));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+
+void BM_ComputeAcceptKey(benchmark::State& state) {
+    const std::string_view key = "dGhlIHNhbXBsZSBub25jZQ==";
+    char out[WebSocketServer::kAcceptKeySize];
+    for (auto _ : state) {
+        WebSocketServer::computeAcceptKey(key, out);
+        benchmark::DoNotOptimize(out);
+    }
+}
+
+void BM_Sha1Hash(benchmark::State& state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5a);
+    uint8_t digest[sha1::kDigestSize];
+    for (auto _ : state) {
+        sha1::hash(data.data(), data.size(), digest);
+        benchmark::DoNotOptimize(digest);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Base64Encode(benchmark::State& state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5a);
+    std::vector<char> out(base64::encodedSize(data.size()));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(base64::encode(data.data(), data.size(), out.data()));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+// Друг RemoteControlServer: сервер з RecordingBackend, команди шарду 0
+// проходять розбір і чергу до потоку ін'єкції, але нічого не вводиться в
+// систему. До шарду ніхто не підключається, тож бенчмарк сам є єдиним
+// виробником його черги. Утримання (OpKeyDown, OpButtonDown) прив'язані до
+// з'єднання з мережевого колбека, тому через цей вхід їх не ганяємо.
+class DispatchBench {
+public:
+    DispatchBench() {
+        server_.setPort(kPort);
+        server_.setRecordInput(true);
+        server_.setCompression(false);
+        server_.start();
+    }
+    ~DispatchBench() { server_.stop(); }
+
+    bool ready() const { return !server_.shards_.empty(); }
+    void message(const std::string& text) { server_.handleMessage(*server_.shards_[0], text); }
+    void binary(const uint8_t* data, size_t size) { server_.handleBinary(*server_.shards_[0], data, size); }
+
+private:
+    RemoteControlServer server_;
+};
+
+namespace {
+
+void BM_HandleMessage(benchmark::State& state) {
+    DispatchBench dispatch;
+    if (!dispatch.ready()) {
+        state.SkipWithError("сервер не запустився");
+        return;
+    }
+    const std::string message = "right";
+    for (auto _ : state) dispatch.message(message);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// range(0) — opcode запису (OpKeyTap або вказівник), range(1) — записів в одному повідомленні
+void BM_HandleBinary(benchmark::State& state) {
+    DispatchBench dispatch;
+    if (!dispatch.ready()) {
+        state.SkipWithError("сервер не запустився");
+        return;
+    }
+    size_t records = static_cast<size_t>(state.range(1));
+    uint8_t op = static_cast<uint8_t>(state.range(0));
+    std::string data = op == proto::OpKeyTap ? commandRecords(op, keys::KeyRight, 1, records)
+                                             : commandRecords(op, 1, 0, records);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    for (auto _ : state) dispatch.binary(bytes, data.size());
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records));
+}
+
+// Ціна для потоку, що пише: форматування й комірка черги. Коли фоновий
+// потік не встигає, INFO відкидаються — як і в роботі сервера.
+void BM_LoggerLog(benchmark::State& state) {
+    const std::string message = "Запуск WebSocket сервера на порту 8765, шардів: 1";
+    for (auto _ : state) Logger::info(message);
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_DecodeWebSocketFrame)->ArgName("payload")->Arg(6)->Arg(96)->Arg(1024);
+BENCHMARK(BM_ComputeAcceptKey);
+BENCHMARK(BM_Sha1Hash)->ArgName("size")->Arg(60)->Arg(1024);
+BENCHMARK(BM_Base64Encode)->ArgName("size")->Arg(20)->Arg(1024);
+BENCHMARK(BM_HandleMessage);
+BENCHMARK(BM_HandleBinary)->ArgNames({"op", "records"})
+    ->Args({proto::OpKeyTap, 1})->Args({proto::OpKeyTap, 16})->Args({proto::OpPointerMove, 16});
+BENCHMARK(BM_LoggerLog)->ThreadRange(1, 2);
+
+int main(int argc, char** argv) {
+    std::vector<char*> args(argv, argv + argc);
+    bool hasOut = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--benchmark_out=", 16) == 0) hasOut = true;
+    }
+    if (!hasOut) args.push_back(const_cast<char*>(kDefaultOut));
+    int count = static_cast<int>(args.size());
+    args.push_back(nullptr);
+
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) return 1;
+    Logger::init("remotecontrol_bench.log");
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    Logger::shutdown();
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "websocket_server.h"
+
+// Увесь WebSocketServer на loopback: клієнти в потоці бенчмарка шлють по
+// одній бінарній команді (8 байтів, з маскою), сервер відповідає ехо-кадром.
+// Порівнюються epoll і io_uring за однакового навантаження. Лічильник
+// ctxsw/cmd — перемикання контексту потоків сервера на команду; кількість
+// системних викликів видно в `strace -c -f` або `perf trace -s`.
+
+namespace {
+
+const uint16_t kPort = 18765;
+const size_t kCommandSize = 8;
+
+int connectClient() {
+    for (int attempt = 0; attempt < 200; attempt++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(kPort);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return -1;
+}
+
+bool readExactly(int fd, char* buf, size_t size) {
+    while (size > 0) {
+        ssize_t n = recv(fd, buf, size, 0);
+        if (n <= 0) return false;
+        buf += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool upgrade(int fd) {
+    static const char kRequest[] =
+        "GET / HTTP/1.1\r\nHost: bench\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    if (send(fd, kRequest, sizeof(kRequest) - 1, 0) != static_cast<ssize_t>(sizeof(kRequest) - 1)) return false;
+    std::string head;
+    char c;
+    while (head.size() < 4 || head.compare(head.size() - 4, 4, "\r\n\r\n") != 0) {
+        if (recv(fd, &c, 1, 0) != 1) return false;
+        head += c;
+    }
+    return head.compare(0, 12, "HTTP/1.1 101") == 0;
+}
+
+// Перемикання контексту всіх потоків, крім поточного (клієнтського)
+long serverContextSwitches() {
+    struct rusage self, thread;
+    getrusage(RUSAGE_SELF, &self);
+    getrusage(RUSAGE_THREAD, &thread);
+    return (self.ru_nvcsw + self.ru_nivcsw) - (thread.ru_nvcsw + thread.ru_nivcsw);
+}
+
+// range(0) — 1 для io_uring, range(1) — кількість клієнтів
+void BM_EchoCommand(benchmark::State& state) {
+    bool ring = state.range(0) != 0;
+    int clients = static_cast<int>(state.range(1));
+
+    WebSocketServer server(kPort);
+    server.setCompression(false);
+    server.setIoUring(ring);
+    server.setBinaryCallback([&server](const uint8_t* data, size_t size) {
+        server.sendBinary(server.messageConnection(), data, size);
+    });
+    server.start();
+
+    std::vector<int> fds;
+    for (int i = 0; i < clients; i++) {
+        int fd = connectClient();
+        if (fd < 0 || !upgrade(fd)) {
+            if (fd >= 0) close(fd);
+            state.SkipWithError("не вдалося підключитися");
+            break;
+        }
+        fds.push_back(fd);
+    }
+
+    // Маскований бінарний кадр з 8-байтовою командою
+    char frame[2 + 4 + kCommandSize] = {static_cast<char>(0x82), static_cast<char>(0x80 | kCommandSize),
+                                        0x11, 0x22, 0x33, 0x44};
+    char reply[2 + kCommandSize];
+    long switches = serverContextSwitches();
+    if (static_cast<int>(fds.size()) == clients) {
+        for (auto _ : state) {
+            for (int fd : fds) send(fd, frame, sizeof(frame), 0);
+            for (int fd : fds) {
+                if (!readExactly(fd, reply, sizeof(reply))) {
+                    state.SkipWithError("з'єднання закрито");
+                    break;
+                }
+            }
+        }
+    }
+    switches = serverContextSwitches() - switches;
+
+    for (int fd : fds) close(fd);
+    server.stop();
+
+    int64_t commands = state.iterations() * clients;
+    state.SetItemsProcessed(commands);
+    state.counters["ctxsw/cmd"] = commands ? static_cast<double>(switches) / commands : 0;
+    state.SetLabel(ring ? "io_uring" : "epoll");
+}
+
+} // namespace
+
+BENCHMARK(BM_EchoCommand)
+    ->ArgNames({"ring", "clients"})
+    ->ArgsProduct({{0, 1}, {1, 16, 128}})
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
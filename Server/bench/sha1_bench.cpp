@@ -0,0 +1,136 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "sha1.h"
+
+namespace {
+
+// Попередня реалізація sha1::hash(): копія входу з padding через new[],
+// розклад на 80 слів, результат у std::string
+namespace legacy {
+
+inline uint32_t leftRotate(uint32_t value, uint32_t amount) {
+    return (value << amount) | (value >> (32 - amount));
+}
+
+void processChunk(const uint8_t* chunk, uint32_t* h) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (chunk[i * 4] << 24) | (chunk[i * 4 + 1] << 16) |
+               (chunk[i * 4 + 2] << 8) | chunk[i * 4 + 3];
+    }
+    for (int i = 16; i < 80; i++)
+        w[i] = leftRotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | ((~b) & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t temp = leftRotate(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = leftRotate(b, 30);
+        b = a;
+        a = temp;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
+
+std::string hash(const unsigned char* data, size_t len) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    size_t paddedLen = ((len + 9 + 63) / 64) * 64;
+    uint8_t* padded = new uint8_t[paddedLen];
+    std::memset(padded, 0, paddedLen);
+    std::memcpy(padded, data, len);
+    padded[len] = 0x80;
+    uint64_t bitLen = static_cast<uint64_t>(len) * 8;
+    for (int i = 0; i < 8; i++)
+        padded[paddedLen - 1 - i] = static_cast<uint8_t>(bitLen >> (8 * i));
+    for (size_t i = 0; i < paddedLen; i += 64)
+        processChunk(padded + i, h);
+    delete[] padded;
+    std::string result;
+    result.reserve(20);
+    for (int i = 0; i < 5; i++) {
+        result += static_cast<char>((h[i] >> 24) & 0xFF);
+        result += static_cast<char>((h[i] >> 16) & 0xFF);
+        result += static_cast<char>((h[i] >> 8) & 0xFF);
+        result += static_cast<char>(h[i] & 0xFF);
+    }
+    return result;
+}
+
+} // namespace legacy
+
+// 24 символи Sec-WebSocket-Key + 36 символів GUID
+const int64_t kHandshakeSize = 60;
+
+void BM_Sha1Legacy(benchmark::State& state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5a);
+    for (auto _ : state) {
+        std::string digest = legacy::hash(data.data(), data.size());
+        benchmark::DoNotOptimize(digest.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Лише обробка блоків конкретною реалізацією: стільки ж блоків, скільки
+// в повному хеші такого розміру, але без padding і без диспетчеризації
+template <sha1::detail::BlocksFn Fn>
+void BM_Sha1Blocks(benchmark::State& state) {
+    size_t len = static_cast<size_t>(state.range(0));
+    size_t blocks = (len + 8) / sha1::kBlockSize + 1;
+    std::vector<uint8_t> data(blocks * sha1::kBlockSize, 0x5a);
+    for (auto _ : state) {
+        uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+        Fn(h, data.data(), blocks);
+        benchmark::DoNotOptimize(h);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Sha1Context(benchmark::State& state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5a);
+    state.SetLabel(sha1::backendName());
+    for (auto _ : state) {
+        uint8_t digest[sha1::kDigestSize];
+        sha1::hash(data.data(), data.size(), digest);
+        benchmark::DoNotOptimize(digest);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void sizes(benchmark::internal::Benchmark* b) {
+    b->Arg(kHandshakeSize)->Arg(4 << 10)->Arg(1 << 20);
+}
+
+} // namespace
+
+BENCHMARK(BM_Sha1Legacy)->Apply(sizes);
+BENCHMARK(BM_Sha1Context)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_Sha1Blocks, sha1::detail::blocksScalar)->Apply(sizes);
+#if defined(SHA1_X86)
+BENCHMARK_TEMPLATE(BM_Sha1Blocks, sha1::detail::blocksShaNi)->Apply(sizes);
+#endif
+#if defined(SHA1_ARMV8)
+BENCHMARK_TEMPLATE(BM_Sha1Blocks, sha1::detail::blocksArmv8)->Apply(sizes);
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "websocket_server.h"
+
+// Шквал підключень, як у relay/hub: kClientThreads потоків одночасно
+// відкривають clients з'єднань і проходять WebSocket upgrade, потім кожне
+// шле одну команду й чекає ехо. Порівнюється один сервер і кілька шардів
+// на SO_REUSEPORT; виграш видно лише на машині з кількома ядрами.
+
+namespace {
+
+const uint16_t kPort = 18766;
+const int kClientThreads = 4;
+const size_t kCommandSize = 8;
+
+int connectClient() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    // RST замість TIME_WAIT: тисячі з'єднань за прогін не вичерпують портів
+    struct linger lin = {1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_LINGER, &lin, sizeof(lin));
+    return fd;
+}
+
+bool readExactly(int fd, char* buf, size_t size) {
+    while (size > 0) {
+        ssize_t n = recv(fd, buf, size, 0);
+        if (n <= 0) return false;
+        buf += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool upgrade(int fd) {
+    static const char kRequest[] =
+        "GET / HTTP/1.1\r\nHost: bench\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    if (send(fd, kRequest, sizeof(kRequest) - 1, 0) != static_cast<ssize_t>(sizeof(kRequest) - 1)) return false;
+    std::string head;
+    char c;
+    while (head.size() < 4 || head.compare(head.size() - 4, 4, "\r\n\r\n") != 0) {
+        if (recv(fd, &c, 1, 0) != 1) return false;
+        head += c;
+    }
+    return head.compare(0, 12, "HTTP/1.1 101") == 0;
+}
+
+// Одна команда на з'єднання: сервер відповідає ехо-кадром
+bool roundTrip(int fd) {
+    char frame[2 + 4 + kCommandSize] = {static_cast<char>(0x82), static_cast<char>(0x80 | kCommandSize),
+                                        0x11, 0x22, 0x33, 0x44};
+    char reply[2 + kCommandSize];
+    return send(fd, frame, sizeof(frame), 0) == static_cast<ssize_t>(sizeof(frame))
+        && readExactly(fd, reply, sizeof(reply));
+}
+
+// range(0) — шардів, range(1) — з'єднань у шквалі
+void BM_ConnectBurst(benchmark::State& state) {
+    int shards = static_cast<int>(state.range(0));
+    int clients = static_cast<int>(state.range(1));
+    unsigned cpus = std::thread::hardware_concurrency();
+
+    std::vector<std::unique_ptr<WebSocketServer>> servers;
+    for (int i = 0; i < shards; i++) {
+        servers.emplace_back(new WebSocketServer(kPort));
+        WebSocketServer& server = *servers.back();
+        server.setCompression(false);
+        if (shards > 1) {
+            server.setReusePort(true);
+            server.setCpu(cpus ? static_cast<int>(i % cpus) : -1);
+        }
+        server.setBinaryCallback([&server](const uint8_t* data, size_t size) {
+            server.sendBinary(server.messageConnection(), data, size);
+        });
+        server.start();
+    }
+    // Сервери слухають, щойно приймається перше з'єднання
+    for (int attempt = 0; attempt < 200; attempt++) {
+        int fd = connectClient();
+        if (fd >= 0) {
+            close(fd);
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::atomic<int> failed{0};
+    for (auto _ : state) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kClientThreads; t++) {
+            threads.emplace_back([&failed, clients, t] {
+                std::vector<int> fds;
+                for (int i = t; i < clients; i += kClientThreads) {
+                    int fd = connectClient();
+                    if (fd < 0 || !upgrade(fd)) {
+                        if (fd >= 0) close(fd);
+                        failed++;
+                        continue;
+                    }
+                    fds.push_back(fd);
+                }
+                for (int fd : fds) {
+                    if (!roundTrip(fd)) failed++;
+                }
+                for (int fd : fds) close(fd);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        if (failed.load() != 0) {
+            state.SkipWithError("не всі з'єднання пройшли");
+            break;
+        }
+    }
+
+    for (auto& server : servers) server->stop();
+    state.SetItemsProcessed(state.iterations() * clients);
+}
+
+} // namespace
+
+BENCHMARK(BM_ConnectBurst)
+    ->ArgNames({"shards", "clients"})
+    ->ArgsProduct({{1, 2, 4}, {256}})
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,187 @@
+#include <benchmark/benchmark.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "tls.h"
+
+// Серверна сторона — tls::Session, як у WebSocketServer; клієнт — голий
+// OpenSSL. Обидва кінці неблокуючої socketpair в одному потоці, тож
+// handshake прокачується по черзі. kTLS на AF_UNIX не буває.
+
+namespace {
+
+struct Fixture {
+    tls::Context server;
+    SSL_CTX* client = nullptr;
+    std::string certPath;
+    std::string keyPath;
+
+    Fixture() {
+        EVP_PKEY* key = EVP_EC_gen("P-256");
+        X509* cert = X509_new();
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 60 * 60);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("bench"),
+                                   -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        X509_sign(cert, key, EVP_sha256());
+
+        char dir[] = "/tmp/tls_bench_XXXXXX";
+        if (!mkdtemp(dir)) abort();
+        certPath = std::string(dir) + "/server.crt";
+        keyPath = std::string(dir) + "/server.key";
+        FILE* f = fopen(certPath.c_str(), "w");
+        PEM_write_X509(f, cert);
+        fclose(f);
+        f = fopen(keyPath.c_str(), "w");
+        PEM_write_PrivateKey(f, key, nullptr, nullptr, 0, nullptr, nullptr);
+        fclose(f);
+        X509_free(cert);
+        EVP_PKEY_free(key);
+
+        if (!server.load(certPath, keyPath)) abort();
+        client = SSL_CTX_new(TLS_client_method());
+    }
+
+    ~Fixture() {
+        SSL_CTX_free(client);
+        std::string dir = certPath.substr(0, certPath.rfind('/'));
+        unlink(certPath.c_str());
+        unlink(keyPath.c_str());
+        rmdir(dir.c_str());
+    }
+};
+
+Fixture& fixture() {
+    static Fixture f;
+    return f;
+}
+
+struct Pair {
+    int fds[2];
+
+    Pair() {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) abort();
+        for (int fd : fds) fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+    ~Pair() {
+        close(fds[0]);
+        close(fds[1]);
+    }
+};
+
+// Handshake до кінця з обох боків; клієнт також забирає квиток сесії
+bool connectPair(tls::Session& server, SSL* client) {
+    SSL_set_connect_state(client);
+    bool clientDone = false;
+    for (int i = 0; i < 100 && !(clientDone && server.established()); i++) {
+        if (!clientDone) {
+            int rc = SSL_do_handshake(client);
+            if (rc == 1) clientDone = true;
+            else if (SSL_get_error(client, rc) != SSL_ERROR_WANT_READ) return false;
+        }
+        if (!server.established() && server.handshake() == tls::Session::Handshake::Failed) return false;
+    }
+    char byte;
+    SSL_read(client, &byte, 1);  // NewSessionTicket (TLS 1.3 шле його після handshake)
+    ERR_clear_error();
+    return clientDone && server.established();
+}
+
+// SSL_free без close_notify позначає сесію клієнта як невідновлювану
+void closeClient(SSL* client) {
+    SSL_shutdown(client);
+    SSL_free(client);
+}
+
+// range(0) — 1, якщо клієнт відновлює сесію квитком
+void BM_Handshake(benchmark::State& state) {
+    Fixture& f = fixture();
+    SSL_SESSION* session = nullptr;
+    if (state.range(0)) {
+        Pair pair;
+        tls::Session server(f.server, pair.fds[0]);
+        SSL* client = SSL_new(f.client);
+        SSL_set_fd(client, pair.fds[1]);
+        if (connectPair(server, client)) session = SSL_get1_session(client);
+        closeClient(client);
+        if (!session) {
+            state.SkipWithError("не вдалося отримати сесію");
+            return;
+        }
+    }
+    int64_t resumed = 0;
+    for (auto _ : state) {
+        Pair pair;
+        tls::Session server(f.server, pair.fds[0]);
+        SSL* client = SSL_new(f.client);
+        SSL_set_fd(client, pair.fds[1]);
+        if (session) SSL_set_session(client, session);
+        if (!connectPair(server, client)) {
+            state.SkipWithError("handshake не вдався");
+            SSL_free(client);
+            break;
+        }
+        resumed += server.resumed();
+        closeClient(client);
+    }
+    if (session) SSL_SESSION_free(session);
+    state.counters["resumed"] = benchmark::Counter(static_cast<double>(resumed), benchmark::Counter::kAvgIterations);
+}
+
+// Один кадр сервер → клієнт: range(0) — 1 для TLS, range(1) — розмір кадру
+void BM_Frame(benchmark::State& state) {
+    Fixture& f = fixture();
+    bool useTls = state.range(0) != 0;
+    size_t size = static_cast<size_t>(state.range(1));
+    Pair pair;
+    tls::Session server(f.server, pair.fds[0]);
+    SSL* client = SSL_new(f.client);
+    SSL_set_fd(client, pair.fds[1]);
+    if (useTls && !connectPair(server, client)) {
+        state.SkipWithError("handshake не вдався");
+        SSL_free(client);
+        return;
+    }
+
+    std::vector<char> frame(size, 'x');
+    std::vector<char> in(size);
+    for (auto _ : state) {
+        size_t sent = 0, got = 0;
+        while (got < size) {
+            if (sent < size) {
+                long long n = useTls ? server.write(frame.data() + sent, size - sent)
+                                     : send(pair.fds[0], frame.data() + sent, size - sent, MSG_NOSIGNAL);
+                if (n > 0) sent += static_cast<size_t>(n);
+            }
+            long long n = useTls ? SSL_read(client, in.data() + got, static_cast<int>(size - got))
+                                 : recv(pair.fds[1], in.data() + got, size - got, 0);
+            if (n > 0) got += static_cast<size_t>(n);
+        }
+        benchmark::DoNotOptimize(in.data());
+    }
+    SSL_free(client);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+    state.SetLabel(useTls ? "tls" : "plain");
+}
+
+} // namespace
+
+BENCHMARK(BM_Handshake)->ArgName("resume")->Arg(0)->Arg(1);
+// 8 байтів — бінарна команда з маскою, 4 KiB — stats, 64 KiB — кілька записів TLS
+BENCHMARK(BM_Frame)->ArgNames({"tls", "size"})->ArgsProduct({{0, 1}, {8, 4096, 65536}});
+
+BENCHMARK_MAIN();
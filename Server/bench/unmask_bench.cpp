@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "ws_unmask.h"
+
+namespace {
+
+const uint8_t kMask[4] = {0x37, 0xfa, 0x21, 0x3d};
+const uint32_t kKey = 0x3d21fa37;
+
+// Попередня реалізація з decodeWebSocketFrame(): побайтово, mask[i % 4], result +=
+void BM_UnmaskLegacy(benchmark::State& state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5a);
+    for (auto _ : state) {
+        std::string result;
+        result.reserve(data.size());
+        for (size_t i = 0; i < data.size(); i++)
+            result += static_cast<char>(data[i] ^ kMask[i % 4]);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+template <ws::detail::UnmaskFn Fn>
+void BM_Unmask(benchmark::State& state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5a);
+    for (auto _ : state) {
+        Fn(data.data(), data.size(), kKey);
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_UnmaskDispatch(benchmark::State& state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5a);
+    state.SetLabel(ws::unmaskBackendName());
+    for (auto _ : state) {
+        ws::unmask(data.data(), data.size(), kMask, 0);
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+#define UNMASK_SIZES RangeMultiplier(8)->Range(2, 1 << 20)
+
+BENCHMARK(BM_UnmaskLegacy)->UNMASK_SIZES;
+BENCHMARK_TEMPLATE(BM_Unmask, ws::detail::unmaskScalar)->UNMASK_SIZES;
+BENCHMARK_TEMPLATE(BM_Unmask, ws::detail::unmaskWord)->UNMASK_SIZES;
+#if defined(WS_UNMASK_X86)
+BENCHMARK_TEMPLATE(BM_Unmask, ws::detail::unmaskSse2)->UNMASK_SIZES;
+void BM_UnmaskAvx2(benchmark::State& state) {
+    if (!ws::detail::cpuHasAvx2()) {
+        state.SkipWithError("AVX2 недоступний");
+        return;
+    }
+    BM_Unmask<ws::detail::unmaskAvx2>(state);
+}
+BENCHMARK(BM_UnmaskAvx2)->UNMASK_SIZES;
+#endif
+#if defined(WS_UNMASK_NEON)
+BENCHMARK_TEMPLATE(BM_Unmask, ws::detail::unmaskNeon)->UNMASK_SIZES;
+#endif
+BENCHMARK(BM_UnmaskDispatch)->UNMASK_SIZES;
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,46 @@
+#!/bin/sh
+# Самопідписаний сертифікат для локального wss:// / https://.
+#
+#   scripts/make_cert.sh [каталог] [додаткова-адреса...]
+#
+# Створює server.crt і server.key (ECDSA P-256, 825 днів — межа, яку ще
+# приймає iOS). У subjectAltName потрапляють localhost, 127.0.0.1, ім'я
+# машини, її адреси в локальній мережі та всі додаткові адреси з аргументів.
+# Запуск сервера:
+#
+#   RemoteControlServer --tls-cert=DIR/server.crt --tls-key=DIR/server.key
+#
+# Телефон має один раз довірити сертифікату: відкрити https://<адреса>:8765/
+# і прийняти попередження (або встановити server.crt як профіль).
+set -e
+
+dir=${1:-.}
+[ $# -gt 0 ] && shift
+mkdir -p "$dir"
+
+host=$(hostname 2>/dev/null || echo localhost)
+san="DNS:localhost,DNS:$host,IP:127.0.0.1"
+
+if command -v hostname >/dev/null 2>&1 && hostname -I >/dev/null 2>&1; then
+    ips=$(hostname -I)
+elif command -v ipconfig >/dev/null 2>&1; then
+    ips=$(ipconfig getifaddr en0 2>/dev/null || true)
+fi
+for ip in $ips "$@"; do
+    case $ip in
+        *:*) ;;                               # IPv6 сервер не слухає
+        *[!0-9.]*) san="$san,DNS:$ip" ;;
+        *) san="$san,IP:$ip" ;;
+    esac
+done
+
+openssl req -x509 -newkey ec -pkeyopt ec_paramgen_curve:prime256v1 -nodes \
+    -days 825 -subj "/CN=$host" \
+    -addext "subjectAltName=$san" \
+    -addext "extendedKeyUsage=serverAuth" \
+    -keyout "$dir/server.key" -out "$dir/server.crt"
+chmod 600 "$dir/server.key"
+
+echo "Сертифікат: $dir/server.crt"
+echo "Ключ:       $dir/server.key"
+echo "SAN:        $san"
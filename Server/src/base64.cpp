@@ -0,0 +1,332 @@
+#include "base64.h"
+
+#if defined(BASE64_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BASE64_TARGET(t) __attribute__((target(t)))
+#else
+#define BASE64_TARGET(t)
+#endif
+
+namespace base64 {
+
+namespace {
+
+const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Символ -> 6 біт; 0xFF — не з алфавіту (зокрема '=')
+struct DecodeTable {
+    uint8_t v[256];
+    constexpr DecodeTable() : v() {
+        for (int i = 0; i < 256; i++) v[i] = 0xFF;
+        for (int i = 0; i < 64; i++) v[static_cast<uint8_t>(kAlphabet[i])] = static_cast<uint8_t>(i);
+    }
+};
+
+constexpr DecodeTable kDecode;
+
+inline uint8_t lookup(char c) {
+    return kDecode.v[static_cast<uint8_t>(c)];
+}
+
+// Останні 4 символи з одним або двома '='. Невикористані біти мають бути нульовими,
+// інакше той самий результат мав би кілька записів.
+bool decodeTail(const char* q, size_t pad, uint8_t* out) {
+    uint8_t a = lookup(q[0]);
+    uint8_t b = lookup(q[1]);
+    uint8_t c = pad == 1 ? lookup(q[2]) : 0;
+    if ((a | b | c) & 0x80) return false;
+    out[0] = static_cast<uint8_t>((a << 2) | (b >> 4));
+    if (pad == 2) return (b & 0x0F) == 0;
+    out[1] = static_cast<uint8_t>((b << 4) | (c >> 2));
+    return (c & 0x03) == 0;
+}
+
+} // namespace
+
+namespace detail {
+
+size_t encodeScalar(const uint8_t* data, size_t len, char* out) {
+    char* o = out;
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        uint32_t v = (static_cast<uint32_t>(data[i]) << 16) | (static_cast<uint32_t>(data[i + 1]) << 8) | data[i + 2];
+        o[0] = kAlphabet[v >> 18];
+        o[1] = kAlphabet[(v >> 12) & 0x3F];
+        o[2] = kAlphabet[(v >> 6) & 0x3F];
+        o[3] = kAlphabet[v & 0x3F];
+        o += 4;
+    }
+    if (i < len) {
+        uint32_t v = static_cast<uint32_t>(data[i]) << 16;
+        if (i + 1 < len) v |= static_cast<uint32_t>(data[i + 1]) << 8;
+        o[0] = kAlphabet[v >> 18];
+        o[1] = kAlphabet[(v >> 12) & 0x3F];
+        o[2] = i + 1 < len ? kAlphabet[(v >> 6) & 0x3F] : '=';
+        o[3] = '=';
+        o += 4;
+    }
+    return static_cast<size_t>(o - out);
+}
+
+bool decodeScalar(const char* data, size_t len, uint8_t* out) {
+    for (size_t i = 0; i < len; i += 4) {
+        uint8_t a = lookup(data[i]);
+        uint8_t b = lookup(data[i + 1]);
+        uint8_t c = lookup(data[i + 2]);
+        uint8_t d = lookup(data[i + 3]);
+        if ((a | b | c | d) & 0x80) return false;
+        out[0] = static_cast<uint8_t>((a << 2) | (b >> 4));
+        out[1] = static_cast<uint8_t>((b << 4) | (c >> 2));
+        out[2] = static_cast<uint8_t>((c << 6) | d);
+        out += 3;
+    }
+    return true;
+}
+
+#if defined(BASE64_X86)
+
+// Векторні ядра за схемою W. Muła / D. Lemire: pshufb розкладає 12 байтів
+// на 16 шестибітних полів, а перетворення поле <-> символ робиться
+// таблицею зсувів, індексованою діапазоном (кодування) або старшим
+// півбайтом символу (декодування).
+
+BASE64_TARGET("ssse3")
+static inline __m128i encodeLanes(__m128i in) {
+    // Кожні 3 байти -> 4 байти, по одному 6-бітному полю в кожному
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i idx = _mm_or_si128(t1, t3);
+
+    // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+    __m128i r = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+    r = _mm_or_si128(r, _mm_and_si128(less, _mm_set1_epi8(13)));
+    const __m128i shift = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                        '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(shift, r), idx);
+}
+
+BASE64_TARGET("ssse3")
+size_t encodeSsse3(const uint8_t* data, size_t len, char* out) {
+    size_t i = 0;
+    char* o = out;
+    // Читаємо 16 байтів, використовуємо 12
+    for (; i + 16 <= len; i += 12, o += 16) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o), encodeLanes(in));
+    }
+    return static_cast<size_t>(o - out) + encodeScalar(data + i, len - i, o);
+}
+
+// Символи -> 6-бітні значення; false, якщо трапився символ поза алфавітом
+BASE64_TARGET("ssse3")
+static inline bool decodeLanes(__m128i in, __m128i& values) {
+    const __m128i hi = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0F));
+    const __m128i lo = _mm_and_si128(in, _mm_set1_epi8(0x0F));
+
+    // Для кожного молодшого півбайта — множина допустимих старших (біт 1 << hi)
+    const __m128i maskLut = _mm_setr_epi8(
+        static_cast<char>(0xA8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+        static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+        static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF0), 0x54,
+        0x50, 0x50, 0x50, 0x54);
+    const __m128i bitLut = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80),
+                                         0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i allowed = _mm_and_si128(_mm_shuffle_epi8(maskLut, lo), _mm_shuffle_epi8(bitLut, hi));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(allowed, _mm_setzero_si128())) != 0) return false;
+
+    // '+' і '/' мають спільний старший півбайт: '/' дістає поправку -3
+    const __m128i shiftLut = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i shift = _mm_shuffle_epi8(shiftLut, hi);
+    shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('/')), _mm_set1_epi8(-3)));
+    values = _mm_add_epi8(in, shift);
+    return true;
+}
+
+// 16 шестибітних значень -> 12 байтів у молодшій частині регістра
+BASE64_TARGET("ssse3")
+static inline __m128i packLanes(__m128i values) {
+    const __m128i ab = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i abcd = _mm_madd_epi16(ab, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(abcd, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+BASE64_TARGET("ssse3")
+bool decodeSsse3(const char* data, size_t len, uint8_t* out) {
+    size_t i = 0;
+    // Пишемо 16 байтів, корисних 12: запас у 8 символів тримає запис у межах out
+    for (; i + 24 <= len; i += 16, out += 12) {
+        __m128i values;
+        if (!decodeLanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), values)) return false;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packLanes(values));
+    }
+    return decodeScalar(data + i, len - i, out);
+}
+
+BASE64_TARGET("avx2")
+size_t encodeAvx2(const uint8_t* data, size_t len, char* out) {
+    const __m256i shuf = _mm256_broadcastsi128_si256(
+        _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m256i shift = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                      '/' - 63, 'A', 0, 0));
+    size_t i = 0;
+    char* o = out;
+    // pshufb працює в межах 128-бітних половин, тож кожна отримує свої 12 байтів
+    for (; i + 28 <= len; i += 24, o += 32) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(a), b, 1);
+        in = _mm256_shuffle_epi8(in, shuf);
+        const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i idx = _mm256_or_si256(t1, t3);
+
+        __m256i r = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx);
+        r = _mm256_or_si256(r, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        r = _mm256_add_epi8(_mm256_shuffle_epi8(shift, r), idx);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(o), r);
+    }
+    return static_cast<size_t>(o - out) + encodeSsse3(data + i, len - i, o);
+}
+
+BASE64_TARGET("avx2")
+bool decodeAvx2(const char* data, size_t len, uint8_t* out) {
+    const __m256i maskLut = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        static_cast<char>(0xA8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+        static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+        static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF0), 0x54,
+        0x50, 0x50, 0x50, 0x54));
+    const __m256i bitLut = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0));
+    const __m256i shiftLut = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0));
+    const __m256i packShuf = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    const __m256i packPerm = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+    size_t i = 0;
+    // Пишемо 32 байти, корисних 24: запас у 16 символів тримає запис у межах out
+    for (; i + 48 <= len; i += 32, out += 24) {
+        const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0F));
+        const __m256i lo = _mm256_and_si256(in, _mm256_set1_epi8(0x0F));
+        const __m256i allowed = _mm256_and_si256(_mm256_shuffle_epi8(maskLut, lo), _mm256_shuffle_epi8(bitLut, hi));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(allowed, _mm256_setzero_si256())) != 0) return false;
+
+        __m256i shift = _mm256_shuffle_epi8(shiftLut, hi);
+        shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('/')),
+                                                        _mm256_set1_epi8(-3)));
+        const __m256i values = _mm256_add_epi8(in, shift);
+
+        const __m256i ab = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        __m256i packed = _mm256_madd_epi16(ab, _mm256_set1_epi32(0x00011000));
+        packed = _mm256_shuffle_epi8(packed, packShuf);
+        packed = _mm256_permutevar8x32_epi32(packed, packPerm);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+    }
+    return decodeSsse3(data + i, len - i, out);
+}
+
+bool cpuHasSsse3() {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    return (regs[2] & (1 << 9)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuid(regs, 1);
+    bool osxsave = (regs[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+} // namespace detail
+
+namespace {
+
+struct Backend {
+    detail::EncodeFn encode;
+    detail::DecodeFn decode;
+    const char* name;
+};
+
+Backend selectBackend() {
+#if defined(BASE64_X86)
+    if (detail::cpuHasAvx2()) return {detail::encodeAvx2, detail::decodeAvx2, "avx2"};
+    if (detail::cpuHasSsse3()) return {detail::encodeSsse3, detail::decodeSsse3, "ssse3"};
+#endif
+    return {detail::encodeScalar, detail::decodeScalar, "scalar"};
+}
+
+const Backend& backend() {
+    static const Backend b = selectBackend();
+    return b;
+}
+
+// Ключі та хеші рукостискання коротші за один векторний блок
+const size_t kVectorMin = 32;
+
+} // namespace
+
+size_t encode(const uint8_t* data, size_t len, char* out) {
+    if (len < kVectorMin) return detail::encodeScalar(data, len, out);
+    return backend().encode(data, len, out);
+}
+
+bool decode(const char* data, size_t len, uint8_t* out, size_t& outLen) {
+    outLen = 0;
+    if (len % 4 != 0) return false;
+    if (len == 0) return true;
+
+    size_t pad = 0;
+    if (data[len - 1] == '=') pad = data[len - 2] == '=' ? 2 : 1;
+    size_t body = pad ? len - 4 : len;
+
+    bool ok = body < kVectorMin ? detail::decodeScalar(data, body, out)
+                                : backend().decode(data, body, out);
+    if (!ok) return false;
+    size_t n = body / 4 * 3;
+    if (pad) {
+        if (!decodeTail(data + body, pad, out + n)) return false;
+        n += 3 - pad;
+    }
+    outLen = n;
+    return true;
+}
+
+const char* backendName() {
+    return backend().name;
+}
+
+} // namespace base64
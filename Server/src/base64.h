@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Base64 (RFC 4648, алфавіт "+/", з padding) у буфери викликача.
+// Реалізація (скалярна, SSSE3 або AVX2) обирається один раз під час виконання.
+namespace base64 {
+
+constexpr size_t encodedSize(size_t len) {
+    return (len + 2) / 3 * 4;
+}
+
+// Верхня межа: точний розмір залежить від padding
+constexpr size_t maxDecodedSize(size_t len) {
+    return len / 4 * 3;
+}
+
+// out — не менше encodedSize(len) байтів; повертає кількість записаних символів
+size_t encode(const uint8_t* data, size_t len, char* out);
+
+// Строге декодування: довжина кратна 4, '=' лише в кінці, без пробілів.
+// out — не менше maxDecodedSize(len) байтів. false — некоректний вхід.
+bool decode(const char* data, size_t len, uint8_t* out, size_t& outLen);
+
+const char* backendName();
+
+// Кодеки, між якими encode()/decode() обирають за CPU: скалярний, SSSE3 і
+// AVX2. base64_bench міряє кожен напряму; padding декодерам знімає decode().
+namespace detail {
+
+// Повне кодування разом із padding; повертає кількість записаних символів
+using EncodeFn = size_t (*)(const uint8_t* data, size_t len, char* out);
+// Тіло без padding: len кратна 4, пише рівно len / 4 * 3 байтів
+using DecodeFn = bool (*)(const char* data, size_t len, uint8_t* out);
+
+size_t encodeScalar(const uint8_t* data, size_t len, char* out);
+bool decodeScalar(const char* data, size_t len, uint8_t* out);
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BASE64_X86 1
+size_t encodeSsse3(const uint8_t* data, size_t len, char* out);
+bool decodeSsse3(const char* data, size_t len, uint8_t* out);
+size_t encodeAvx2(const uint8_t* data, size_t len, char* out);
+bool decodeAvx2(const char* data, size_t len, uint8_t* out);
+bool cpuHasSsse3();
+bool cpuHasAvx2();
+#endif
+
+} // namespace detail
+} // namespace base64
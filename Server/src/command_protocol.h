@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Бінарний протокол команд (WebSocket opcode 0x2).
+// Повідомлення складається з одного або кількох записів по kRecordSize байтів,
+// усі поля little-endian:
+//   0     u8   op         — код операції (Op)
+//   1     u8   modifiers  — бітова маска Modifier
+//   2..3  u16  key        — код клавіші (keys::KeyId, див. key_table.h)
+//   4..5  u16  repeat     — кількість натискань (0 трактується як 1), лише OpKeyTap
+// Для операцій вказівника key і repeat — це x і y (див. Op).
+//   6..7  u16  reserved
+//   8..11 u32  timestamp  — час клієнта в мс (performance.now() mod 2^32)
+namespace proto {
+
+enum Op : uint8_t {
+    OpKeyTap = 0x01,
+    // Клавіша лишається натиснутою до OpKeyUp від того ж з'єднання; якщо
+    // з'єднання закрилося раніше, сервер відпускає її сам. modifiers
+    // ігноруються — модифікатори утримуються як звичайні клавіші.
+    OpKeyDown = 0x02,
+    OpKeyUp = 0x03,
+    // Вказівник. Рух і прокрутка сумуються на сервері й вводяться раз на
+    // тік, тож клієнт може слати їх з кожною подією pointermove.
+    OpPointerMove = 0x10,   // x, y: i16 — зсув у пікселях
+    OpPointerMoveTo = 0x11, // x, y: u16 — 0..65535 від ширини й висоти екрана
+    OpButtonDown = 0x12,    // key — MouseButton (1 ліва, 2 середня, 3 права);
+    OpButtonUp = 0x13,      //   як і клавіші, відпускається при закритті з'єднання
+    OpScroll = 0x14         // x, y: i16 — клацання коліщатка, y > 0 — вниз
+};
+
+enum Modifier : uint8_t {
+    ModShift = 1 << 0,
+    ModCtrl  = 1 << 1,
+    ModAlt   = 1 << 2,
+    ModSuper = 1 << 3
+};
+
+const size_t kRecordSize = 12;
+
+struct Command {
+    uint8_t op;
+    uint8_t modifiers;
+    uint16_t key;
+    uint16_t repeat;
+    uint32_t timestamp;
+};
+
+inline uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+         | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// key/repeat операцій OpPointerMove і OpScroll
+inline int16_t toSigned(uint16_t v) {
+    return v < 0x8000 ? static_cast<int16_t>(v) : static_cast<int16_t>(static_cast<int32_t>(v) - 0x10000);
+}
+
+inline Command decode(const uint8_t* p) {
+    Command c;
+    c.op = p[0];
+    c.modifiers = p[1];
+    c.key = readU16(p + 2);
+    c.repeat = readU16(p + 4);
+    if (c.repeat == 0 && c.op == OpKeyTap) c.repeat = 1;
+    c.timestamp = readU32(p + 8);
+    return c;
+}
+
+} // namespace proto
@@ -0,0 +1,271 @@
+#include "event_poller.h"
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#elif defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+EventPoller::~EventPoller() {
+    close();
+}
+
+#if defined(__linux__)
+
+namespace {
+
+uint32_t toEpoll(uint32_t events) {
+    uint32_t ev = EPOLLET | EPOLLRDHUP;
+    if (events & EventPoller::Readable) ev |= EPOLLIN;
+    if (events & EventPoller::Writable) ev |= EPOLLOUT;
+    return ev;
+}
+
+} // namespace
+
+bool EventPoller::open() {
+    if (epollFd_ != -1) return true;
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ == -1) return false;
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = wakeFd_;
+    if (wakeFd_ == -1 || epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void EventPoller::close() {
+    if (wakeFd_ != -1) {
+        ::close(wakeFd_);
+        wakeFd_ = -1;
+    }
+    if (epollFd_ != -1) {
+        ::close(epollFd_);
+        epollFd_ = -1;
+    }
+}
+
+void EventPoller::wake() {
+    uint64_t one = 1;
+    ssize_t n = write(wakeFd_, &one, sizeof(one));
+    (void)n; // лічильник переповнений — пробудження й так уже очікує
+}
+
+void EventPoller::drainWake() {
+    uint64_t value;
+    ssize_t n = read(wakeFd_, &value, sizeof(value));
+    (void)n;
+}
+
+bool EventPoller::add(intptr_t fd, uint32_t events) {
+    struct epoll_event ev = {};
+    ev.events = toEpoll(events);
+    ev.data.fd = static_cast<int>(fd);
+    return epoll_ctl(epollFd_, EPOLL_CTL_ADD, static_cast<int>(fd), &ev) == 0;
+}
+
+bool EventPoller::modify(intptr_t fd, uint32_t events) {
+    struct epoll_event ev = {};
+    ev.events = toEpoll(events);
+    ev.data.fd = static_cast<int>(fd);
+    return epoll_ctl(epollFd_, EPOLL_CTL_MOD, static_cast<int>(fd), &ev) == 0;
+}
+
+void EventPoller::remove(intptr_t fd) {
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, static_cast<int>(fd), nullptr);
+}
+
+int EventPoller::wait(Event* out, int maxEvents, int timeoutMs) {
+    const int kBatch = 64;
+    struct epoll_event evs[kBatch];
+    int n = epoll_wait(epollFd_, evs, std::min(maxEvents, kBatch), timeoutMs);
+    if (n < 0) return errno == EINTR ? 0 : -1;
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        if (evs[i].data.fd == wakeFd_) {
+            drainWake();
+            continue;
+        }
+        uint32_t e = 0;
+        if (evs[i].events & (EPOLLIN | EPOLLRDHUP)) e |= Readable;
+        if (evs[i].events & EPOLLOUT) e |= Writable;
+        if (evs[i].events & (EPOLLERR | EPOLLHUP)) e |= Error;
+        out[count].fd = evs[i].data.fd;
+        out[count].events = e;
+        count++;
+    }
+    return count;
+}
+
+const char* EventPoller::backendName() {
+    return "epoll";
+}
+
+intptr_t EventPoller::nativeHandle() const {
+    return epollFd_;
+}
+
+#else
+
+bool EventPoller::open() {
+    if (open_) return true;
+#ifdef _WIN32
+    // WSAPoll не вміє чекати на pipe, тому будимо себе UDP-датаграмою на loopback
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET) return false;
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int len = sizeof(addr);
+    u_long nonBlocking = 1;
+    if (bind(s, reinterpret_cast<struct sockaddr*>(&addr), len) != 0
+        || getsockname(s, reinterpret_cast<struct sockaddr*>(&addr), &len) != 0
+        || connect(s, reinterpret_cast<struct sockaddr*>(&addr), len) != 0
+        || ioctlsocket(s, FIONBIO, &nonBlocking) != 0) {
+        closesocket(s);
+        return false;
+    }
+    wakeRead_ = wakeWrite_ = static_cast<intptr_t>(s);
+#else
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    for (int fd : fds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    wakeRead_ = fds[0];
+    wakeWrite_ = fds[1];
+#endif
+    open_ = true;
+    return true;
+}
+
+void EventPoller::close() {
+    entries_.clear();
+#ifdef _WIN32
+    if (wakeRead_ != -1) closesocket(static_cast<SOCKET>(wakeRead_));
+#else
+    if (wakeRead_ != -1) ::close(static_cast<int>(wakeRead_));
+    if (wakeWrite_ != -1) ::close(static_cast<int>(wakeWrite_));
+#endif
+    wakeRead_ = wakeWrite_ = -1;
+    open_ = false;
+}
+
+void EventPoller::wake() {
+    char one = 1;
+#ifdef _WIN32
+    send(static_cast<SOCKET>(wakeWrite_), &one, 1, 0);
+#else
+    ssize_t n = write(static_cast<int>(wakeWrite_), &one, 1);
+    (void)n; // pipe заповнений — пробудження й так уже очікує
+#endif
+}
+
+void EventPoller::drainWake() {
+    char buf[64];
+#ifdef _WIN32
+    while (recv(static_cast<SOCKET>(wakeRead_), buf, sizeof(buf), 0) > 0) {}
+#else
+    while (read(static_cast<int>(wakeRead_), buf, sizeof(buf)) > 0) {}
+#endif
+}
+
+bool EventPoller::add(intptr_t fd, uint32_t events) {
+    if (!open_) return false;
+    entries_.push_back({fd, events});
+    return true;
+}
+
+bool EventPoller::modify(intptr_t fd, uint32_t events) {
+    for (auto& e : entries_) {
+        if (e.fd == fd) {
+            e.events = events;
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventPoller::remove(intptr_t fd) {
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+        [fd](const Entry& e) { return e.fd == fd; }), entries_.end());
+}
+
+int EventPoller::wait(Event* out, int maxEvents, int timeoutMs) {
+    // Останній елемент — канал пробудження
+#ifdef _WIN32
+    std::vector<WSAPOLLFD> pfds(entries_.size() + 1);
+    pfds.back().fd = static_cast<SOCKET>(wakeRead_);
+#else
+    std::vector<struct pollfd> pfds(entries_.size() + 1);
+    pfds.back().fd = static_cast<int>(wakeRead_);
+#endif
+    pfds.back().events = POLLIN;
+    pfds.back().revents = 0;
+    for (size_t i = 0; i < entries_.size(); i++) {
+#ifdef _WIN32
+        pfds[i].fd = static_cast<SOCKET>(entries_[i].fd);
+#else
+        pfds[i].fd = static_cast<int>(entries_[i].fd);
+#endif
+        pfds[i].events = 0;
+        if (entries_[i].events & Readable) pfds[i].events |= POLLIN;
+        if (entries_[i].events & Writable) pfds[i].events |= POLLOUT;
+        pfds[i].revents = 0;
+    }
+#ifdef _WIN32
+    int n = WSAPoll(pfds.data(), static_cast<ULONG>(pfds.size()), timeoutMs);
+    if (n < 0) return -1;
+#else
+    int n = poll(pfds.data(), static_cast<nfds_t>(pfds.size()), timeoutMs);
+    if (n < 0) return errno == EINTR ? 0 : -1;
+#endif
+    if (pfds.back().revents) drainWake();
+    // Обхід починається після останнього виданого дескриптора: коли готових
+    // більше за maxEvents, решта дістанеться наступному виклику, а не знову першим
+    int count = 0;
+    size_t size = entries_.size();
+    size_t start = size ? next_ % size : 0;
+    for (size_t k = 0; k < size && count < maxEvents; k++) {
+        size_t i = (start + k) % size;
+        if (!pfds[i].revents) continue;
+        next_ = i + 1;
+        uint32_t e = 0;
+        if (pfds[i].revents & POLLIN) e |= Readable;
+        if (pfds[i].revents & POLLOUT) e |= Writable;
+        if (pfds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) e |= Error;
+        out[count].fd = entries_[i].fd;
+        out[count].events = e;
+        count++;
+    }
+    return count;
+}
+
+const char* EventPoller::backendName() {
+#ifdef _WIN32
+    return "WSAPoll";
+#else
+    return "poll";
+#endif
+}
+
+intptr_t EventPoller::nativeHandle() const {
+    return wakeRead_;
+}
+
+#endif
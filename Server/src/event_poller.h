@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Обгортка над механізмом очікування подій сокетів:
+// epoll (edge-triggered) на Linux, poll/WSAPoll на інших платформах.
+// Обробник завжди має читати/приймати до EAGAIN, тоді обидва бекенди
+// поводяться однаково.
+// wake() можна викликати з будь-якого потоку: він перериває wait()
+// (eventfd на Linux, pipe на інших POSIX, UDP-сокет на себе у Windows).
+class EventPoller {
+public:
+    enum : uint32_t {
+        Readable = 1u << 0,
+        Writable = 1u << 1,
+        Error    = 1u << 2
+    };
+
+    struct Event {
+        intptr_t fd;
+        uint32_t events;
+    };
+
+    EventPoller() = default;
+    ~EventPoller();
+
+    EventPoller(const EventPoller&) = delete;
+    EventPoller& operator=(const EventPoller&) = delete;
+
+    bool open();
+    void close();
+
+    bool add(intptr_t fd, uint32_t events);
+    bool modify(intptr_t fd, uint32_t events);
+    void remove(intptr_t fd);
+
+    // Повертає кількість подій у out (0 при таймауті, -1 при помилці).
+    int wait(Event* out, int maxEvents, int timeoutMs);
+
+    // Будить потік, що чекає у wait(); сама подія пробудження назовні не видається
+    void wake();
+
+    static const char* backendName();
+
+    // Дескриптор, що стає читабельним після wake() (на Linux — epoll, тобто й
+    // від будь-якої іншої події): так цикл io_uring чекає пробудження poll'ом
+    intptr_t nativeHandle() const;
+
+private:
+    void drainWake();
+
+#if defined(__linux__)
+    int epollFd_ = -1;
+    int wakeFd_ = -1;
+#else
+    struct Entry {
+        intptr_t fd;
+        uint32_t events;
+    };
+    std::vector<Entry> entries_;
+    size_t next_ = 0; // з якого запису wait() почне видавати події
+    bool open_ = false;
+    intptr_t wakeRead_ = -1;
+    intptr_t wakeWrite_ = -1;
+#endif
+};
@@ -0,0 +1,207 @@
+#include "http_parser.h"
+#include <cstring>
+
+namespace http {
+
+namespace {
+
+char toLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// tchar з RFC 7230 §3.2.6
+bool isTokenChar(char c) {
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) return true;
+    return c != 0 && std::strchr("!#$%&'*+-.^_`|~", c) != nullptr;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Викликає fn для кожного непорожнього елемента списку через кому
+template <typename Fn>
+bool anyListItem(std::string_view list, Fn fn) {
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        std::string_view item = trim(list.substr(0, comma));
+        if (!item.empty() && fn(item)) return true;
+        if (comma == std::string_view::npos) break;
+        list.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+std::string_view stripWeak(std::string_view etag) {
+    if (etag.size() >= 2 && etag[0] == 'W' && etag[1] == '/') etag.remove_prefix(2);
+    return etag;
+}
+
+} // namespace
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (toLower(a[i]) != toLower(b[i])) return false;
+    }
+    return true;
+}
+
+bool hasToken(std::string_view list, std::string_view token) {
+    return anyListItem(list, [token](std::string_view item) { return equalsIgnoreCase(item, token); });
+}
+
+bool acceptsEncoding(std::string_view acceptEncoding, std::string_view coding) {
+    return anyListItem(acceptEncoding, [coding](std::string_view item) {
+        size_t semi = item.find(';');
+        if (!equalsIgnoreCase(trim(item.substr(0, semi)), coding)) return false;
+        if (semi == std::string_view::npos) return true;
+        // Вага q=0 (q=0, q=0.0, q=0.000) означає "не надсилати"
+        std::string_view q = trim(item.substr(semi + 1));
+        if (q.size() < 3 || (q[0] != 'q' && q[0] != 'Q') || q[1] != '=') return true;
+        q.remove_prefix(2);
+        for (char c : q) {
+            if (c != '0' && c != '.') return true;
+        }
+        return false;
+    });
+}
+
+bool etagMatches(std::string_view ifNoneMatch, std::string_view etag) {
+    if (trim(ifNoneMatch) == "*") return true;
+    etag = stripWeak(etag);
+    return anyListItem(ifNoneMatch, [etag](std::string_view item) { return stripWeak(item) == etag; });
+}
+
+bool decodePath(std::string_view target, char* out, size_t capacity, size_t& len) {
+    target = target.substr(0, target.find_first_of("?#"));
+    if (target.empty() || target.front() != '/') return false;
+    len = 0;
+    for (size_t i = 0; i < target.size(); i++) {
+        char c = target[i];
+        if (c == '%') {
+            int hi = i + 2 < target.size() ? hexValue(target[i + 1]) : -1;
+            int lo = hi >= 0 ? hexValue(target[i + 2]) : -1;
+            if (lo < 0) return false;
+            c = static_cast<char>(hi * 16 + lo);
+            i += 2;
+        }
+        if (c == 0 || len == capacity) return false;
+        out[len++] = c;
+    }
+    return true;
+}
+
+char* RequestParser::writePtr(size_t& room) {
+    room = kMaxRequestSize - size_;
+    return buf_ + size_;
+}
+
+RequestParser::Status RequestParser::fail(const char* text) {
+    errorText_ = text;
+    status_ = Status::Error;
+    return status_;
+}
+
+RequestParser::Status RequestParser::commit(size_t n) {
+    size_ += n;
+    if (status_ != Status::NeedMore) return status_;
+
+    // Розбираємо лише повні рядки, що з'явилися після попереднього виклику
+    for (;;) {
+        const char* start = buf_ + parsed_;
+        const char* nl = static_cast<const char*>(std::memchr(start, '\n', size_ - parsed_));
+        if (!nl) {
+            if (size_ == kMaxRequestSize) return fail("завеликий HTTP-запит");
+            return Status::NeedMore;
+        }
+        std::string_view line(start, static_cast<size_t>(nl - start));
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        parsed_ = static_cast<size_t>(nl - buf_) + 1;
+
+        if (!requestLine_) {
+            if (line.empty()) continue; // RFC 7230 §3.5: порожні рядки перед запитом ігноруються
+            if (!parseRequestLine(line)) return fail("некоректний рядок запиту");
+            requestLine_ = true;
+        } else if (line.empty()) {
+            status_ = Status::Done;
+            return status_;
+        } else if (!parseHeader(line)) {
+            return status_ == Status::Error ? status_ : fail("некоректний заголовок");
+        }
+    }
+}
+
+bool RequestParser::parseRequestLine(std::string_view line) {
+    size_t sp1 = line.find(' ');
+    if (sp1 == std::string_view::npos || sp1 == 0) return false;
+    size_t sp2 = line.find(' ', sp1 + 1);
+    if (sp2 == std::string_view::npos || sp2 == sp1 + 1) return false;
+    method_ = line.substr(0, sp1);
+    target_ = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    version_ = line.substr(sp2 + 1);
+    for (char c : method_) {
+        if (!isTokenChar(c)) return false;
+    }
+    return version_.size() == 8 && version_.compare(0, 5, "HTTP/") == 0;
+}
+
+bool RequestParser::parseHeader(std::string_view line) {
+    // obs-fold (рядок-продовження) заборонений для запитів, RFC 7230 §3.2.4
+    if (line.front() == ' ' || line.front() == '\t') return false;
+    size_t colon = line.find(':');
+    if (colon == std::string_view::npos || colon == 0) return false;
+    std::string_view name = line.substr(0, colon);
+    for (char c : name) {
+        if (!isTokenChar(c)) return false;
+    }
+    if (headerCount_ == kMaxHeaders) {
+        fail("забагато заголовків");
+        return false;
+    }
+    headers_[headerCount_].name = name;
+    headers_[headerCount_].value = trim(line.substr(colon + 1));
+    headerCount_++;
+    return true;
+}
+
+std::string_view RequestParser::header(std::string_view name) const {
+    for (size_t i = 0; i < headerCount_; i++) {
+        if (equalsIgnoreCase(headers_[i].name, name)) return headers_[i].value;
+    }
+    return std::string_view();
+}
+
+bool RequestParser::hasBody() const {
+    for (size_t i = 0; i < headerCount_; i++) {
+        const Header& h = headers_[i];
+        if (equalsIgnoreCase(h.name, "Transfer-Encoding")) return true;
+        if (equalsIgnoreCase(h.name, "Content-Length")
+            && (h.value.empty() || h.value.find_first_not_of('0') != std::string_view::npos))
+            return true;
+    }
+    return false;
+}
+
+void RequestParser::reset() {
+    size_t left = size_ - parsed_;
+    if (left > 0 && parsed_ > 0) std::memmove(buf_, buf_ + parsed_, left);
+    size_ = left;
+    parsed_ = 0;
+    requestLine_ = false;
+    status_ = Status::NeedMore;
+    errorText_ = "";
+    method_ = target_ = version_ = std::string_view();
+    headerCount_ = 0;
+}
+
+} // namespace http
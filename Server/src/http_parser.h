@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace http {
+
+struct Header {
+    std::string_view name;
+    std::string_view value; // без пробілів по краях
+};
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b);
+
+// Чи містить список через кому (як у Connection/Upgrade) токен, без урахування регістру
+bool hasToken(std::string_view list, std::string_view token);
+
+// Чи приймає клієнт кодування за Accept-Encoding (з урахуванням ";q=0")
+bool acceptsEncoding(std::string_view acceptEncoding, std::string_view coding);
+
+// Чи збігається ETag з If-None-Match (список або "*"); порівняння слабке, RFC 7232 §3.2
+bool etagMatches(std::string_view ifNoneMatch, std::string_view etag);
+
+// Шлях із request-target: без query, з розкодованими %XX. false — некоректний
+// (не абсолютний, NUL або завеликий для out).
+bool decodePath(std::string_view target, char* out, size_t capacity, size_t& len);
+
+// Відновлюваний розбір запиту HTTP/1.1 (рядок запиту + заголовки, без тіла).
+// Байти з сокета пишуться прямо у внутрішній буфер фіксованого розміру;
+// кожен commit() розбирає лише нові повні рядки, тож запит може приходити
+// будь-якими шматками. Усі string_view вказують у цей буфер і дійсні до reset().
+class RequestParser {
+public:
+    static const size_t kMaxRequestSize = 8192;
+    static const size_t kMaxHeaders = 32;
+
+    enum class Status {
+        NeedMore,  // кінця заголовків ще немає
+        Done,      // запит розібрано
+        Error      // некоректний або завеликий запит
+    };
+
+    RequestParser() = default;
+    RequestParser(const RequestParser&) = delete;
+    RequestParser& operator=(const RequestParser&) = delete;
+
+    // Вільне місце для recv(); room == 0 — запит перевищив kMaxRequestSize
+    char* writePtr(size_t& room);
+    Status commit(size_t n);
+
+    Status status() const { return status_; }
+    const char* errorText() const { return errorText_; }
+
+    std::string_view method() const { return method_; }
+    std::string_view target() const { return target_; }
+    std::string_view version() const { return version_; }
+
+    size_t headerCount() const { return headerCount_; }
+    const Header& headerAt(size_t i) const { return headers_[i]; }
+    // Значення першого заголовка з такою назвою (регістр не важливий), або порожнє
+    std::string_view header(std::string_view name) const;
+    // Чи оголошено тіло: Transfer-Encoding або Content-Length, відмінний від 0.
+    // Тіла розбирач не читає — після такого запиту з'єднання слід закрити,
+    // інакше тіло розбиралося б як наступний запит.
+    bool hasBody() const;
+
+    // Байти, що прийшли після кінця заголовків (наприклад, перші WebSocket-кадри)
+    std::string_view extra() const { return std::string_view(buf_ + parsed_, size_ - parsed_); }
+
+    // Готує до наступного запиту того ж з'єднання; extra() переноситься на початок
+    // буфера. Уже наявні байти розбираються наступним commit() (можна commit(0)).
+    void reset();
+
+private:
+    Status fail(const char* text);
+    bool parseRequestLine(std::string_view line);
+    bool parseHeader(std::string_view line);
+
+    char buf_[kMaxRequestSize];
+    size_t size_ = 0;    // байтів у буфері
+    size_t parsed_ = 0;  // початок першого нерозібраного рядка
+    bool requestLine_ = false;
+    Status status_ = Status::NeedMore;
+    const char* errorText_ = "";
+
+    std::string_view method_;
+    std::string_view target_;
+    std::string_view version_;
+    Header headers_[kMaxHeaders];
+    size_t headerCount_ = 0;
+};
+
+} // namespace http
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "key_table.h"
+
+enum MouseButton : uint16_t {
+    ButtonLeft = 1,
+    ButtonMiddle = 2,
+    ButtonRight = 3,
+    kButtonCount = 4
+};
+
+// Межі за один виклик на кожну вісь: накопичена прокрутка стає окремими
+// клацаннями (X11 — пара подій на клацання), і без межі шквал OpScroll
+// займав би потік ін'єкції на секунди
+const int kMaxScrollClicks = 64;
+const int kMaxMoveDelta = 16384;
+
+// Системний ввід для потоку ін'єкції KeyboardSimulator. Бекенд обирається під
+// час запуску (KeyboardSimulator::setBackend); усі методи, крім деструктора,
+// викликаються лише з потоку ін'єкції.
+class InputBackend {
+public:
+    virtual ~InputBackend() = default;
+
+    virtual const char* name() const = 0;
+
+    // Відкриває з'єднання з системою вводу на початку потоку ін'єкції
+    virtual bool open() = 0;
+    virtual void close() {}
+
+    // Код для keyDown/keyUp або -1; викликається раз на клавішу після open()
+    virtual int keyCode(keys::KeyId key) = 0;
+    virtual void keyDown(int keyCode) = 0;
+    virtual void keyUp(int keyCode) = 0;
+
+    // x, y для moveTo — 0..65535 від розміру екрана; button — MouseButton
+    virtual void moveBy(int dx, int dy) = 0;
+    virtual void moveTo(int x, int y) = 0;
+    virtual void button(int button, bool press) = 0;
+    // Клацання коліщатка; y > 0 — вниз, x > 0 — праворуч. Бекенд обрізає
+    // кожну вісь до kMaxScrollClicks
+    virtual void scroll(int dx, int dy) = 0;
+
+    // Передає системі події після keyDown/keyUp/... однією пачкою
+    virtual void flush() = 0;
+};
+
+// X11/XTest, SendInput або CoreGraphics — залежно від платформи збірки
+std::unique_ptr<InputBackend> createPlatformInputBackend();
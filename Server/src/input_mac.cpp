@@ -0,0 +1,133 @@
+#include "input_backend.h"
+#include "logger.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <CoreGraphics/CoreGraphics.h>
+
+namespace {
+
+// Події створюються одразу, а CGEventPost іде серією у flush()
+class MacBackend : public InputBackend {
+public:
+    ~MacBackend() override {
+        for (CGEventRef event : pending_) CFRelease(event);
+    }
+
+    const char* name() const override { return "CoreGraphics"; }
+
+    bool open() override { return true; }
+
+    int keyCode(keys::KeyId key) override {
+        uint16_t code = keys::kKeys[key].mac;
+        return code != keys::kNone ? code : -1;
+    }
+
+    void keyDown(int keyCode) override {
+        CGEventRef keyDownEvent = CGEventCreateKeyboardEvent(nullptr, keyCode, true);
+        if (keyDownEvent) {
+            pending_.push_back(keyDownEvent);
+        } else {
+            Logger::error("Помилка створення події натискання клавіші (код: " + std::to_string(keyCode) + ")");
+        }
+    }
+
+    void keyUp(int keyCode) override {
+        CGEventRef keyUpEvent = CGEventCreateKeyboardEvent(nullptr, keyCode, false);
+        if (keyUpEvent) {
+            pending_.push_back(keyUpEvent);
+        } else {
+            Logger::error("Помилка створення події відпускання клавіші (код: " + std::to_string(keyCode) + ")");
+        }
+    }
+
+    void moveBy(int dx, int dy) override {
+        CGPoint at = cursorLocation();
+        queueMotion(CGPointMake(at.x + dx, at.y + dy));
+    }
+
+    void moveTo(int x, int y) override {
+        CGRect bounds = CGDisplayBounds(CGMainDisplayID());
+        queueMotion(CGPointMake(bounds.origin.x + x * (bounds.size.width - 1) / 65535.0,
+                                bounds.origin.y + y * (bounds.size.height - 1) / 65535.0));
+    }
+
+    void button(int button, bool press) override {
+        CGEventType type;
+        CGMouseButton which;
+        if (button == ButtonLeft) {
+            type = press ? kCGEventLeftMouseDown : kCGEventLeftMouseUp;
+            which = kCGMouseButtonLeft;
+        } else if (button == ButtonRight) {
+            type = press ? kCGEventRightMouseDown : kCGEventRightMouseUp;
+            which = kCGMouseButtonRight;
+        } else {
+            type = press ? kCGEventOtherMouseDown : kCGEventOtherMouseUp;
+            which = kCGMouseButtonCenter;
+        }
+        if (press) buttonsDown_ |= 1u << button;
+        else buttonsDown_ &= ~(1u << button);
+        queueEvent(CGEventCreateMouseEvent(nullptr, type, cursorLocation(), which));
+    }
+
+    // Додатне колесо в CoreGraphics — вгору/вліво
+    void scroll(int dx, int dy) override {
+        dx = std::clamp(dx, -kMaxScrollClicks, kMaxScrollClicks);
+        dy = std::clamp(dy, -kMaxScrollClicks, kMaxScrollClicks);
+        queueEvent(CGEventCreateScrollWheelEvent(nullptr, kCGScrollEventUnitLine, 2, -dy, -dx));
+    }
+
+    void flush() override {
+        for (CGEventRef event : pending_) {
+            CGEventPost(kCGHIDEventTap, event);
+            CFRelease(event);
+        }
+        pending_.clear();
+        cursorKnown_ = false;
+    }
+
+private:
+    void queueEvent(CGEventRef event) {
+        if (event) pending_.push_back(event);
+        else Logger::error("Помилка створення події вказівника");
+    }
+
+    // Події ще не надіслані, тож позицію курсора до flush() ведемо самі
+    CGPoint cursorLocation() {
+        if (!cursorKnown_) {
+            CGEventRef current = CGEventCreate(nullptr);
+            cursor_ = current ? CGEventGetLocation(current) : CGPointZero;
+            if (current) CFRelease(current);
+            cursorKnown_ = true;
+        }
+        return cursor_;
+    }
+
+    // Рух з натиснутою кнопкою — це drag
+    void queueMotion(CGPoint to) {
+        CGEventType type = kCGEventMouseMoved;
+        CGMouseButton which = kCGMouseButtonLeft;
+        if (buttonsDown_ & (1u << ButtonLeft)) {
+            type = kCGEventLeftMouseDragged;
+        } else if (buttonsDown_ & (1u << ButtonRight)) {
+            type = kCGEventRightMouseDragged;
+            which = kCGMouseButtonRight;
+        } else if (buttonsDown_ & (1u << ButtonMiddle)) {
+            type = kCGEventOtherMouseDragged;
+            which = kCGMouseButtonCenter;
+        }
+        cursor_ = to;
+        queueEvent(CGEventCreateMouseEvent(nullptr, type, to, which));
+    }
+
+    std::vector<CGEventRef> pending_;
+    CGPoint cursor_ = CGPointZero;
+    bool cursorKnown_ = false;
+    unsigned buttonsDown_ = 0; // біт на MouseButton
+};
+
+} // namespace
+
+std::unique_ptr<InputBackend> createPlatformInputBackend() {
+    return std::unique_ptr<InputBackend>(new MacBackend());
+}
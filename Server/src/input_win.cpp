@@ -0,0 +1,79 @@
+#include "input_backend.h"
+#include <algorithm>
+#include <vector>
+#include <windows.h>
+
+namespace {
+
+// Події збираються до flush() і вставляються одним SendInput
+class WindowsBackend : public InputBackend {
+public:
+    const char* name() const override { return "SendInput"; }
+
+    bool open() override { return true; }
+
+    int keyCode(keys::KeyId key) override {
+        uint16_t vk = keys::kKeys[key].win;
+        return vk != keys::kNone ? vk : -1;
+    }
+
+    void keyDown(int keyCode) override { queueKey(keyCode, true); }
+    void keyUp(int keyCode) override { queueKey(keyCode, false); }
+
+    void moveBy(int dx, int dy) override { queueMouse(MOUSEEVENTF_MOVE, dx, dy); }
+
+    // MOUSEEVENTF_ABSOLUTE має ту саму шкалу 0..65535 основного екрана
+    void moveTo(int x, int y) override { queueMouse(MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE, x, y); }
+
+    void button(int button, bool press) override {
+        static const DWORD kFlags[kButtonCount][2] = {
+            {0, 0},
+            {MOUSEEVENTF_LEFTUP, MOUSEEVENTF_LEFTDOWN},
+            {MOUSEEVENTF_MIDDLEUP, MOUSEEVENTF_MIDDLEDOWN},
+            {MOUSEEVENTF_RIGHTUP, MOUSEEVENTF_RIGHTDOWN},
+        };
+        queueMouse(kFlags[button][press ? 1 : 0]);
+    }
+
+    // dy > 0 — вниз, як deltaY у браузері; колесо Windows рахує навпаки
+    void scroll(int dx, int dy) override {
+        dx = std::clamp(dx, -kMaxScrollClicks, kMaxScrollClicks);
+        dy = std::clamp(dy, -kMaxScrollClicks, kMaxScrollClicks);
+        if (dy) queueMouse(MOUSEEVENTF_WHEEL, 0, 0, static_cast<DWORD>(-dy * WHEEL_DELTA));
+        if (dx) queueMouse(MOUSEEVENTF_HWHEEL, 0, 0, static_cast<DWORD>(dx * WHEEL_DELTA));
+    }
+
+    // Масив SendInput вставляється в потік вводу атомарно, без чужих подій між ними
+    void flush() override {
+        if (pending_.empty()) return;
+        SendInput(static_cast<UINT>(pending_.size()), pending_.data(), sizeof(INPUT));
+        pending_.clear();
+    }
+
+private:
+    void queueKey(int vk, bool press) {
+        INPUT in = {};
+        in.type = INPUT_KEYBOARD;
+        in.ki.wVk = static_cast<WORD>(vk);
+        in.ki.dwFlags = press ? 0 : KEYEVENTF_KEYUP;
+        pending_.push_back(in);
+    }
+
+    void queueMouse(DWORD flags, LONG dx = 0, LONG dy = 0, DWORD data = 0) {
+        INPUT in = {};
+        in.type = INPUT_MOUSE;
+        in.mi.dx = dx;
+        in.mi.dy = dy;
+        in.mi.mouseData = data;
+        in.mi.dwFlags = flags;
+        pending_.push_back(in);
+    }
+
+    std::vector<INPUT> pending_;
+};
+
+} // namespace
+
+std::unique_ptr<InputBackend> createPlatformInputBackend() {
+    return std::unique_ptr<InputBackend>(new WindowsBackend());
+}
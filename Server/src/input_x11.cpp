@@ -0,0 +1,91 @@
+#include "input_backend.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <X11/Xlib.h>
+#include <X11/keysym.h>
+#include <X11/extensions/XTest.h>
+
+namespace {
+
+// Постійне з'єднання з дисплеєм на весь час роботи потоку ін'єкції
+class X11Backend : public InputBackend {
+public:
+    const char* name() const override { return "X11/XTest"; }
+
+    bool open() override {
+        display_ = XOpenDisplay(nullptr);
+        if (!display_) {
+            Logger::error("XOpenDisplay failed");
+            return false;
+        }
+        int screen = XDefaultScreen(display_);
+        screenWidth_ = XDisplayWidth(display_, screen);
+        screenHeight_ = XDisplayHeight(display_, screen);
+        return true;
+    }
+
+    void close() override {
+        if (!display_) return;
+        XCloseDisplay(display_);
+        display_ = nullptr;
+    }
+
+    int keyCode(keys::KeyId key) override {
+        int kc = XKeysymToKeycode(display_, static_cast<KeySym>(keys::kKeys[key].x11));
+        return (kc != 0) ? kc : -1;
+    }
+
+    void keyDown(int keyCode) override {
+        XTestFakeKeyEvent(display_, static_cast<unsigned int>(keyCode), True, CurrentTime);
+    }
+
+    void keyUp(int keyCode) override {
+        XTestFakeKeyEvent(display_, static_cast<unsigned int>(keyCode), False, CurrentTime);
+    }
+
+    void moveBy(int dx, int dy) override {
+        XTestFakeRelativeMotionEvent(display_, dx, dy, CurrentTime);
+    }
+
+    void moveTo(int x, int y) override {
+        int px = static_cast<int>(static_cast<int64_t>(x) * (screenWidth_ - 1) / 65535);
+        int py = static_cast<int>(static_cast<int64_t>(y) * (screenHeight_ - 1) / 65535);
+        XTestFakeMotionEvent(display_, -1, px, py, CurrentTime);
+    }
+
+    void button(int button, bool press) override {
+        XTestFakeButtonEvent(display_, static_cast<unsigned int>(button), press ? True : False, CurrentTime);
+    }
+
+    // Прокрутка в X11 — це клацання кнопок 4/5 (вертикаль) і 6/7 (горизонталь)
+    void scroll(int dx, int dy) override {
+        dx = std::clamp(dx, -kMaxScrollClicks, kMaxScrollClicks);
+        dy = std::clamp(dy, -kMaxScrollClicks, kMaxScrollClicks);
+        clicks(dy > 0 ? 5 : 4, std::abs(dy));
+        clicks(dx > 0 ? 7 : 6, std::abs(dx));
+    }
+
+    // XTestFake* лише пишуть у буфер Xlib; на сервер усе йде одним XFlush
+    void flush() override {
+        XFlush(display_);
+    }
+
+private:
+    void clicks(unsigned int button, int count) {
+        for (int i = 0; i < count; i++) {
+            XTestFakeButtonEvent(display_, button, True, CurrentTime);
+            XTestFakeButtonEvent(display_, button, False, CurrentTime);
+        }
+    }
+
+    Display* display_ = nullptr;
+    int screenWidth_ = 0; // для moveTo, знімається при відкритті дисплея
+    int screenHeight_ = 0;
+};
+
+} // namespace
+
+std::unique_ptr<InputBackend> createPlatformInputBackend() {
+    return std::unique_ptr<InputBackend>(new X11Backend());
+}
@@ -0,0 +1,330 @@
+#include "io_ring.h"
+
+#ifdef REMOTECONTROL_HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+const int kMaxParts = 32;       // iovec на один sendmsg
+const uint16_t kBufferGroup = 0;
+
+template <typename T>
+T loadAcquire(const T* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+template <typename T>
+void storeRelease(T* p, T v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+std::string setupError(int err) {
+    switch (err) {
+    case ENOSYS:
+        return "ядро без io_uring";
+    case EINVAL:
+        return "ядро старіше за 6.1";
+    case EPERM:
+    case EACCES:
+        return "io_uring заборонено (kernel.io_uring_disabled або seccomp)";
+    default:
+        return strerror(err);
+    }
+}
+
+} // namespace
+
+struct IoRing::Slot {
+    struct msghdr msg;
+    struct iovec parts[kMaxParts];
+};
+
+IoRing::IoRing() {}
+
+IoRing::~IoRing() {
+    close();
+}
+
+bool IoRing::open(unsigned entries, unsigned bufferCount, size_t bufferSize) {
+    if (fd_ != -1) return true;
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    // Завершення обробляються лише всередині wait() мережевого потоку:
+    // ядро не перериває його task work'ом і не будить зайвий раз
+    p.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN
+            | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    p.cq_entries = entries * 8; // multishot recv дає багато завершень на один SQE
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &p));
+    if (fd < 0) {
+        error_ = setupError(errno);
+        return false;
+    }
+    fd_ = fd;
+    const unsigned kRequired = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_SUBMIT_STABLE
+                             | IORING_FEAT_EXT_ARG;
+    if ((p.features & kRequired) != kRequired) {
+        error_ = "ядро без потрібних можливостей io_uring";
+        close();
+        return false;
+    }
+
+    ringSize_ = std::max(p.sq_off.array + p.sq_entries * sizeof(unsigned),
+                         p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe));
+    ringMem_ = mmap(nullptr, ringSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    sqesSize_ = p.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+    if (ringMem_ == MAP_FAILED || sqes == MAP_FAILED) {
+        if (ringMem_ == MAP_FAILED) ringMem_ = nullptr;
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize_);
+        error_ = "mmap кілець io_uring";
+        close();
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+    char* ring = static_cast<char*>(ringMem_);
+    sqHead_ = reinterpret_cast<unsigned*>(ring + p.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned*>(ring + p.sq_off.tail);
+    sqMask_ = *reinterpret_cast<unsigned*>(ring + p.sq_off.ring_mask);
+    sqEntries_ = p.sq_entries;
+    sqeTail_ = *sqTail_;
+    unsigned* array = reinterpret_cast<unsigned*>(ring + p.sq_off.array);
+    for (unsigned i = 0; i < p.sq_entries; i++) array[i] = i;
+    cqHead_ = reinterpret_cast<unsigned*>(ring + p.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned*>(ring + p.cq_off.tail);
+    cqMask_ = *reinterpret_cast<unsigned*>(ring + p.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(ring + p.cq_off.cqes);
+    slots_.reset(new Slot[p.sq_entries]);
+
+    // Кільце наданих буферів: ядро саме бере вільний буфер під кожен recv,
+    // тож тисяча з'єднань, що мовчать, не тримає тисячу буферів
+    bufRingSize_ = bufferCount * sizeof(struct io_uring_buf);
+    void* bufRing = mmap(nullptr, bufRingSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (bufRing == MAP_FAILED) {
+        error_ = "mmap кільця буферів";
+        close();
+        return false;
+    }
+    bufRing_ = static_cast<io_uring_buf*>(bufRing);
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(bufRing);
+    reg.ring_entries = bufferCount;
+    reg.bgid = kBufferGroup;
+    if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        error_ = "реєстрація кільця буферів: " + setupError(errno);
+        close();
+        return false;
+    }
+    bufMask_ = bufferCount - 1;
+    bufferSize_ = bufferSize;
+    buffers_.reset(new uint8_t[bufferCount * bufferSize]);
+    bufTail_ = 0;
+    for (unsigned i = 0; i < bufferCount; i++) releaseBuffer(static_cast<int>(i));
+    return true;
+}
+
+void IoRing::close() {
+    // Закриття дескриптора скасовує все, що ще в ядрі
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    if (bufRing_) munmap(bufRing_, bufRingSize_);
+    if (sqes_) munmap(sqes_, sqesSize_);
+    if (ringMem_) munmap(ringMem_, ringSize_);
+    bufRing_ = nullptr;
+    sqes_ = nullptr;
+    ringMem_ = nullptr;
+    slots_.reset();
+    buffers_.reset();
+}
+
+int IoRing::enter(unsigned toSubmit, unsigned minComplete, unsigned flags, const void* arg, size_t argSize) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd_, toSubmit, minComplete, flags, arg, argSize));
+}
+
+io_uring_sqe* IoRing::nextSqe() {
+    if (sqeTail_ - loadAcquire(sqHead_) >= sqEntries_ && (submit() < 0 || sqeTail_ - loadAcquire(sqHead_) >= sqEntries_))
+        return nullptr;
+    io_uring_sqe* sqe = &sqes_[sqeTail_ & sqMask_];
+    memset(sqe, 0, sizeof(*sqe));
+    sqeTail_++;
+    return sqe;
+}
+
+bool IoRing::reserve(unsigned count) {
+    if (sqeTail_ - loadAcquire(sqHead_) + count <= sqEntries_) return true;
+    return submit() >= 0 && sqeTail_ - loadAcquire(sqHead_) + count <= sqEntries_;
+}
+
+bool IoRing::acceptMultishot(intptr_t fd, uint64_t userData) {
+    io_uring_sqe* sqe = nextSqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = static_cast<int>(fd);
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->user_data = userData;
+    return true;
+}
+
+bool IoRing::recv(intptr_t fd, void* buf, size_t size, uint64_t userData) {
+    io_uring_sqe* sqe = nextSqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = static_cast<int>(fd);
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = static_cast<uint32_t>(size);
+    sqe->user_data = userData;
+    return true;
+}
+
+bool IoRing::recvMultishot(intptr_t fd, uint64_t userData) {
+    io_uring_sqe* sqe = nextSqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = static_cast<int>(fd);
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->user_data = userData;
+    return true;
+}
+
+bool IoRing::sendmsg(intptr_t fd, const struct iovec* parts, int count, int flags, bool link, uint64_t userData) {
+    if (count > kMaxParts) return false;
+    io_uring_sqe* sqe = nextSqe();
+    if (!sqe) return false;
+    Slot& slot = slots_[(sqeTail_ - 1) & sqMask_];
+    memcpy(slot.parts, parts, static_cast<size_t>(count) * sizeof(struct iovec));
+    memset(&slot.msg, 0, sizeof(slot.msg));
+    slot.msg.msg_iov = slot.parts;
+    slot.msg.msg_iovlen = static_cast<size_t>(count);
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = static_cast<int>(fd);
+    sqe->addr = reinterpret_cast<uint64_t>(&slot.msg);
+    sqe->len = 1;
+    sqe->msg_flags = static_cast<uint32_t>(flags);
+    if (link) sqe->flags = IOSQE_IO_LINK;
+    sqe->user_data = userData;
+    return true;
+}
+
+bool IoRing::poll(intptr_t fd, uint32_t events, bool multishot, uint64_t userData) {
+    io_uring_sqe* sqe = nextSqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = static_cast<int>(fd);
+    sqe->poll32_events = events;
+    if (multishot) sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = userData;
+    return true;
+}
+
+void IoRing::releaseBuffer(int buffer) {
+    // Перший запис кільця ділить пам'ять із tail, тому поле resv не чіпаємо
+    io_uring_buf& b = bufRing_[bufTail_ & bufMask_];
+    b.addr = reinterpret_cast<uint64_t>(bufferData(buffer));
+    b.len = static_cast<uint32_t>(bufferSize_);
+    b.bid = static_cast<uint16_t>(buffer);
+    bufTail_++;
+    storeRelease(&bufRing_[0].resv, bufTail_);
+}
+
+int IoRing::submit() {
+    unsigned toSubmit = sqeTail_ - loadAcquire(sqHead_);
+    if (toSubmit == 0) return 0;
+    storeRelease(sqTail_, sqeTail_);
+    int n = enter(toSubmit, 0, 0, nullptr, 0);
+    return n < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY ? -1 : std::max(n, 0);
+}
+
+int IoRing::wait(Completion* out, int maxCompletions, int timeoutMs) {
+    unsigned toSubmit = sqeTail_ - loadAcquire(sqHead_);
+    storeRelease(sqTail_, sqeTail_);
+    // Одним io_uring_enter: подання, виконання відкладеного task work і очікування
+    struct __kernel_timespec ts;
+    ts.tv_sec = timeoutMs / 1000;
+    ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.ts = reinterpret_cast<uint64_t>(&ts);
+    bool ready = loadAcquire(cqTail_) != *cqHead_;
+    int rc = enter(toSubmit, ready ? 0 : 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    if (rc < 0 && errno != ETIME && errno != EINTR && errno != EAGAIN && errno != EBUSY) return -1;
+
+    unsigned head = *cqHead_;
+    unsigned tail = loadAcquire(cqTail_);
+    int count = 0;
+    for (; head != tail && count < maxCompletions; head++) {
+        const io_uring_cqe& cqe = cqes_[head & cqMask_];
+        Completion& c = out[count++];
+        c.userData = cqe.user_data;
+        c.result = cqe.res;
+        c.more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+        c.buffer = (cqe.flags & IORING_CQE_F_BUFFER) ? static_cast<int>(cqe.flags >> IORING_CQE_BUFFER_SHIFT) : -1;
+    }
+    storeRelease(cqHead_, head);
+    return count;
+}
+
+#else
+
+struct IoRing::Slot {};
+
+IoRing::IoRing() {}
+
+IoRing::~IoRing() {}
+
+bool IoRing::open(unsigned, unsigned, size_t) {
+    error_ = "зібрано без io_uring";
+    return false;
+}
+
+void IoRing::close() {}
+
+bool IoRing::acceptMultishot(intptr_t, uint64_t) {
+    return false;
+}
+
+bool IoRing::recv(intptr_t, void*, size_t, uint64_t) {
+    return false;
+}
+
+bool IoRing::recvMultishot(intptr_t, uint64_t) {
+    return false;
+}
+
+bool IoRing::sendmsg(intptr_t, const struct iovec*, int, int, bool, uint64_t) {
+    return false;
+}
+
+bool IoRing::poll(intptr_t, uint32_t, bool, uint64_t) {
+    return false;
+}
+
+bool IoRing::reserve(unsigned) {
+    return false;
+}
+
+void IoRing::releaseBuffer(int) {}
+
+int IoRing::submit() {
+    return -1;
+}
+
+int IoRing::wait(Completion*, int, int) {
+    return -1;
+}
+
+#endif
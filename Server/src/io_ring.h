@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+struct iovec;
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf;
+
+// Кільце io_uring на сирих системних викликах (без liburing), лише те, що
+// потрібно серверу: multishot accept, multishot recv з кільцем наданих
+// буферів, ланцюжки sendmsg і poll. Потрібне ядро 6.1+ (DEFER_TASKRUN,
+// multishot recv); на старішому, без io_uring або з ним вимкненим open()
+// повертає false, і сервер лишається на EventPoller.
+// Кільце однопотокове: усі виклики — з потоку, що викликав open().
+// Без REMOTECONTROL_HAVE_IO_URING (не Linux) open() завжди повертає false.
+class IoRing {
+public:
+    struct Completion {
+        uint64_t userData;
+        int32_t result;  // як у системного виклику: байти/дескриптор або -errno
+        bool more;       // multishot-операція лишається активною
+        int buffer;      // наданий буфер з даними recv (releaseBuffer()), або -1
+    };
+
+    IoRing();
+    ~IoRing();
+
+    IoRing(const IoRing&) = delete;
+    IoRing& operator=(const IoRing&) = delete;
+
+    // entries — розмір черги подання; bufferCount (степінь двійки) буферів
+    // по bufferSize байтів для recvMultishot()
+    bool open(unsigned entries, unsigned bufferCount, size_t bufferSize);
+    void close();
+    bool opened() const { return fd_ != -1; }
+    // Чому open() не вдався — для логу
+    const std::string& error() const { return error_; }
+
+    // Операції стають у чергу і йдуть у ядро наступним wait() або submit().
+    // false — черга повна навіть після submit().
+    bool acceptMultishot(intptr_t fd, uint64_t userData);
+    // Буфер має жити до завершення
+    bool recv(intptr_t fd, void* buf, size_t size, uint64_t userData);
+    bool recvMultishot(intptr_t fd, uint64_t userData);
+    // parts копіюються (ядро читає їх під час подання), байти мають жити до
+    // завершення. link — наступна операція почнеться лише після повного
+    // успіху цієї, інакше завершиться з -ECANCELED.
+    bool sendmsg(intptr_t fd, const struct iovec* parts, int count, int flags, bool link, uint64_t userData);
+    // Одноразове очікування подій poll (POLLIN/POLLOUT) або multishot
+    bool poll(intptr_t fd, uint32_t events, bool multishot, uint64_t userData);
+
+    // Гарантує count вільних місць у черзі (подає її за потреби), щоб ланцюжок
+    // не розірвався посередині
+    bool reserve(unsigned count);
+
+    const uint8_t* bufferData(int buffer) const { return buffers_.get() + static_cast<size_t>(buffer) * bufferSize_; }
+    void releaseBuffer(int buffer);
+
+    // Подає чергу без очікування; кількість поданих або -1
+    int submit();
+    // Подає чергу й чекає хоча б одне завершення, але не довше timeoutMs.
+    // Повертає кількість у out (0 при таймауті, -1 при помилці).
+    int wait(Completion* out, int maxCompletions, int timeoutMs);
+
+    static const char* backendName() { return "io_uring"; }
+
+private:
+    struct Slot;
+
+    io_uring_sqe* nextSqe();
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags, const void* arg, size_t argSize);
+
+    int fd_ = -1;
+    void* ringMem_ = nullptr;
+    size_t ringSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned sqEntries_ = 0;
+    unsigned sqeTail_ = 0;  // локальний хвіст: ще не опубліковані для ядра SQE
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    std::unique_ptr<Slot[]> slots_; // msghdr/iovec для sendmsg, по одному на SQE
+
+    io_uring_buf* bufRing_ = nullptr;
+    size_t bufRingSize_ = 0;
+    unsigned bufMask_ = 0;
+    uint16_t bufTail_ = 0;
+    std::unique_ptr<uint8_t[]> buffers_;
+    size_t bufferSize_ = 0;
+
+    std::string error_;
+};
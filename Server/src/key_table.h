@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Повний набір клавіш, що їх може надіслати клієнт, з кодами для кожної платформи.
+// Пошук за назвою — через ідеальний хеш, побудований під час компіляції:
+// один хеш, одне порівняння, без алокацій, регістр не враховується.
+namespace keys {
+
+const uint16_t kNone = 0xFFFF; // клавіші немає на платформі
+
+// X(ідентифікатор, назва, X11 keysym, Windows VK, macOS CGKeyCode)
+// Перші чотири (стрілки) збігаються з колишнім ArrowKey і кодами бінарного протоколу.
+#define REMOTECONTROL_KEYS(X) \
+    X(Up,         "up",         0xFF52, 0x26, 0x7E) \
+    X(Down,       "down",       0xFF54, 0x28, 0x7D) \
+    X(Left,       "left",       0xFF51, 0x25, 0x7B) \
+    X(Right,      "right",      0xFF53, 0x27, 0x7C) \
+    X(A,          "a",          0x0061, 0x41, 0x00) \
+    X(B,          "b",          0x0062, 0x42, 0x0B) \
+    X(C,          "c",          0x0063, 0x43, 0x08) \
+    X(D,          "d",          0x0064, 0x44, 0x02) \
+    X(E,          "e",          0x0065, 0x45, 0x0E) \
+    X(F,          "f",          0x0066, 0x46, 0x03) \
+    X(G,          "g",          0x0067, 0x47, 0x05) \
+    X(H,          "h",          0x0068, 0x48, 0x04) \
+    X(I,          "i",          0x0069, 0x49, 0x22) \
+    X(J,          "j",          0x006A, 0x4A, 0x26) \
+    X(K,          "k",          0x006B, 0x4B, 0x28) \
+    X(L,          "l",          0x006C, 0x4C, 0x25) \
+    X(M,          "m",          0x006D, 0x4D, 0x2E) \
+    X(N,          "n",          0x006E, 0x4E, 0x2D) \
+    X(O,          "o",          0x006F, 0x4F, 0x1F) \
+    X(P,          "p",          0x0070, 0x50, 0x23) \
+    X(Q,          "q",          0x0071, 0x51, 0x0C) \
+    X(R,          "r",          0x0072, 0x52, 0x0F) \
+    X(S,          "s",          0x0073, 0x53, 0x01) \
+    X(T,          "t",          0x0074, 0x54, 0x11) \
+    X(U,          "u",          0x0075, 0x55, 0x20) \
+    X(V,          "v",          0x0076, 0x56, 0x09) \
+    X(W,          "w",          0x0077, 0x57, 0x0D) \
+    X(X,          "x",          0x0078, 0x58, 0x07) \
+    X(Y,          "y",          0x0079, 0x59, 0x10) \
+    X(Z,          "z",          0x007A, 0x5A, 0x06) \
+    X(Digit0,     "0",          0x0030, 0x30, 0x1D) \
+    X(Digit1,     "1",          0x0031, 0x31, 0x12) \
+    X(Digit2,     "2",          0x0032, 0x32, 0x13) \
+    X(Digit3,     "3",          0x0033, 0x33, 0x14) \
+    X(Digit4,     "4",          0x0034, 0x34, 0x15) \
+    X(Digit5,     "5",          0x0035, 0x35, 0x17) \
+    X(Digit6,     "6",          0x0036, 0x36, 0x16) \
+    X(Digit7,     "7",          0x0037, 0x37, 0x1A) \
+    X(Digit8,     "8",          0x0038, 0x38, 0x1C) \
+    X(Digit9,     "9",          0x0039, 0x39, 0x19) \
+    X(F1,         "f1",         0xFFBE, 0x70, 0x7A) \
+    X(F2,         "f2",         0xFFBF, 0x71, 0x78) \
+    X(F3,         "f3",         0xFFC0, 0x72, 0x63) \
+    X(F4,         "f4",         0xFFC1, 0x73, 0x76) \
+    X(F5,         "f5",         0xFFC2, 0x74, 0x60) \
+    X(F6,         "f6",         0xFFC3, 0x75, 0x61) \
+    X(F7,         "f7",         0xFFC4, 0x76, 0x62) \
+    X(F8,         "f8",         0xFFC5, 0x77, 0x64) \
+    X(F9,         "f9",         0xFFC6, 0x78, 0x65) \
+    X(F10,        "f10",        0xFFC7, 0x79, 0x6D) \
+    X(F11,        "f11",        0xFFC8, 0x7A, 0x67) \
+    X(F12,        "f12",        0xFFC9, 0x7B, 0x6F) \
+    X(Home,       "home",       0xFF50, 0x24, 0x73) \
+    X(End,        "end",        0xFF57, 0x23, 0x77) \
+    X(PageUp,     "pageup",     0xFF55, 0x21, 0x74) \
+    X(PageDown,   "pagedown",   0xFF56, 0x22, 0x79) \
+    X(Insert,     "insert",     0xFF63, 0x2D, 0x72) \
+    X(Delete,     "delete",     0xFFFF, 0x2E, 0x75) \
+    X(Enter,      "enter",      0xFF0D, 0x0D, 0x24) \
+    X(Escape,     "escape",     0xFF1B, 0x1B, 0x35) \
+    X(Tab,        "tab",        0xFF09, 0x09, 0x30) \
+    X(Space,      "space",      0x0020, 0x20, 0x31) \
+    X(Backspace,  "backspace",  0xFF08, 0x08, 0x33) \
+    X(CapsLock,   "capslock",   0xFFE5, 0x14, 0x39) \
+    X(VolumeUp,   "volumeup",   0x1008FF13, 0xAF, 0x48) \
+    X(VolumeDown, "volumedown", 0x1008FF11, 0xAE, 0x49) \
+    X(Mute,       "mute",       0x1008FF12, 0xAD, 0x4A) \
+    X(PlayPause,  "playpause",  0x1008FF14, 0xB3, kNone) \
+    X(NextTrack,  "nexttrack",  0x1008FF17, 0xB0, kNone) \
+    X(PrevTrack,  "prevtrack",  0x1008FF16, 0xB1, kNone) \
+    X(MediaStop,  "stop",       0x1008FF15, 0xB2, kNone) \
+    X(Shift,      "shift",      0xFFE1, 0x10, 0x38) \
+    X(Ctrl,       "ctrl",       0xFFE3, 0x11, 0x3B) \
+    X(Alt,        "alt",        0xFFE9, 0x12, 0x3A) \
+    X(Super,      "super",      0xFFEB, 0x5B, 0x37)
+
+enum KeyId : uint16_t {
+#define X(id, name, x11, win, mac) Key##id,
+    REMOTECONTROL_KEYS(X)
+#undef X
+    kKeyCount
+};
+
+const KeyId kInvalidKey = kKeyCount;
+
+struct KeyInfo {
+    const char* name;
+    uint32_t x11;
+    uint16_t win;
+    uint16_t mac;
+};
+
+constexpr KeyInfo kKeys[kKeyCount] = {
+#define X(id, name, x11, win, mac) {name, x11, win, mac},
+    REMOTECONTROL_KEYS(X)
+#undef X
+};
+
+struct Alias {
+    const char* name;
+    KeyId key;
+};
+
+constexpr Alias kAliases[] = {
+    {"return",   KeyEnter},
+    {"esc",      KeyEscape},
+    {"del",      KeyDelete},
+    {"pgup",     KeyPageUp},
+    {"pgdn",     KeyPageDown},
+    {"control",  KeyCtrl},
+    {"option",   KeyAlt},
+    {"meta",     KeySuper},
+    {"win",      KeySuper},
+    {"cmd",      KeySuper},
+    {"command",  KeySuper},
+    {"play",     KeyPlayPause},
+    {"next",     KeyNextTrack},
+    {"prev",     KeyPrevTrack},
+    {"previous", KeyPrevTrack},
+};
+
+namespace detail {
+
+const size_t kAliasCount = sizeof(kAliases) / sizeof(kAliases[0]);
+const size_t kNameCount = kKeyCount + kAliasCount;
+const size_t kSlots = 1024;
+const uint32_t kMaxSeed = 100000;
+
+static_assert(kNameCount < 255, "індекс назви має вміщатися в uint8_t");
+
+constexpr char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+constexpr const char* nameAt(size_t i) {
+    return i < kKeyCount ? kKeys[i].name : kAliases[i - kKeyCount].name;
+}
+
+constexpr KeyId keyAt(size_t i) {
+    return i < kKeyCount ? static_cast<KeyId>(i) : kAliases[i - kKeyCount].key;
+}
+
+// FNV-1a по символах у нижньому регістрі з домішаним seed і фінальним перемішуванням
+constexpr uint32_t hash(std::string_view s, uint32_t seed) {
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (char c : s) {
+        h ^= static_cast<uint8_t>(lower(c));
+        h *= 16777619u;
+    }
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h;
+}
+
+struct PerfectHash {
+    uint32_t seed;
+    uint8_t slots[kSlots]; // індекс назви + 1, 0 — порожньо
+};
+
+// Перебирає seed, доки всі назви не потраплять у різні комірки
+constexpr PerfectHash build() {
+    for (uint32_t seed = 1; seed < kMaxSeed; seed++) {
+        PerfectHash p{};
+        p.seed = seed;
+        bool ok = true;
+        for (size_t i = 0; i < kNameCount && ok; i++) {
+            uint32_t slot = hash(nameAt(i), seed) & (kSlots - 1);
+            if (p.slots[slot]) ok = false;
+            else p.slots[slot] = static_cast<uint8_t>(i + 1);
+        }
+        if (ok) return p;
+    }
+    return PerfectHash{};
+}
+
+constexpr PerfectHash kHash = build();
+static_assert(kHash.seed != 0, "не вдалося побудувати ідеальний хеш назв клавіш");
+
+constexpr bool equalsIgnoreCase(std::string_view input, const char* name) {
+    size_t i = 0;
+    for (; i < input.size(); i++) {
+        if (name[i] == '\0' || lower(input[i]) != name[i]) return false;
+    }
+    return name[i] == '\0';
+}
+
+} // namespace detail
+
+// Повертає kInvalidKey, якщо назва невідома
+constexpr KeyId find(std::string_view name) {
+    size_t idx = detail::kHash.slots[detail::hash(name, detail::kHash.seed) & (detail::kSlots - 1)];
+    if (idx == 0 || !detail::equalsIgnoreCase(name, detail::nameAt(idx - 1)))
+        return kInvalidKey;
+    return detail::keyAt(idx - 1);
+}
+
+inline const char* name(KeyId key) {
+    return key < kKeyCount ? kKeys[key].name : "";
+}
+
+static_assert(find("LEFT") == KeyLeft && find("Right") == KeyRight, "стрілки мають знаходитися");
+static_assert(find("cmd") == KeySuper && find("nope") == kInvalidKey, "синоніми та відсутні назви");
+
+} // namespace keys
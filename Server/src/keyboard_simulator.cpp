@@ -1,148 +1,627 @@
 #include "keyboard_simulator.h"
 #include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
-#if defined(_WIN32)
-#include <windows.h>
-#elif defined(__linux__)
-#include <X11/Xlib.h>
-#include <X11/keysymdef.h>
-#include <X11/extensions/XTest.h>
-#include <unistd.h>
-#elif defined(__APPLE__)
-#include <CoreGraphics/CoreGraphics.h>
-#include <unistd.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <signal.h>
 #endif
 
-bool KeyboardSimulator::simulateArrowKey(ArrowKey key) {
-#if defined(_WIN32)
-    int vk = getKeyCode(key);
-    if (vk == -1) return false;
-    INPUT down = {};
-    down.type = INPUT_KEYBOARD;
-    down.ki.wVk = static_cast<WORD>(vk);
-    INPUT up = {};
-    up.type = INPUT_KEYBOARD;
-    up.ki.wVk = static_cast<WORD>(vk);
-    up.ki.dwFlags = KEYEVENTF_KEYUP;
-    SendInput(1, &down, sizeof(INPUT));
-    Sleep(50);
-    SendInput(1, &up, sizeof(INPUT));
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class EventKind : uint8_t {
+    Synthetic,   // з KeyAction::Tap або кроку послідовності
+    Held,        // KeyAction::Press/Release
+    SequenceEnd, // не клавіша, а кінець послідовності з injectSequence()
+    Move,        // накопичений відносний рух (x, y)
+    MoveTo,      // x, y — 0..65535 від розміру екрана
+    Button,      // keyCode — MouseButton
+    Scroll       // накопичена прокрутка (x, y)
+};
+
+struct KeyEvent {
+    int keyCode;
+    bool press;
+    Clock::time_point due;
+    uint64_t seq;
+    latency::Timing timing; // лише для першого натискання основної клавіші команди
+    EventKind kind;
+    int x = 0;
+    int y = 0;
+};
+
+// Рух і прокрутка, що ще не стали подіями: з кожного PointerMove/Scroll
+// лише додається зсув (до kMaxMoveDelta і kMaxScrollClicks), а вводиться
+// один раз на тік
+// Накопичення за тік з насиченням: два злиті int32 не переповнюють int
+int addClamped(int acc, int32_t delta, int limit) {
+    return static_cast<int>(std::clamp<int64_t>(static_cast<int64_t>(acc) + delta, -limit, limit));
+}
+
+struct PendingPointer {
+    bool moveTo = false;
+    int toX = 0;
+    int toY = 0;
+    int dx = 0;
+    int dy = 0;
+    int scrollX = 0;
+    int scrollY = 0;
+
+    bool empty() const { return !moveTo && dx == 0 && dy == 0 && scrollX == 0 && scrollY == 0; }
+};
+
+struct LaterFirst {
+    bool operator()(const KeyEvent& a, const KeyEvent& b) const {
+        if (a.due != b.due) return a.due > b.due;
+        return a.seq > b.seq;
+    }
+};
+
+// Порядок бітів proto::Modifier: Shift, Ctrl, Alt, Super
+const keys::KeyId kModifierKeys[4] = {keys::KeyShift, keys::KeyCtrl, keys::KeyAlt, keys::KeySuper};
+
+bool mergeCommands(KeyCommand& into, const KeyCommand& from) {
+    if (into.action != KeyAction::Tap || from.action != KeyAction::Tap) return false;
+    if (into.key != from.key || into.modifiers != from.modifiers) return false;
+    uint32_t repeat = static_cast<uint32_t>(into.repeat) + from.repeat;
+    into.repeat = static_cast<uint16_t>(repeat > 0xFFFF ? 0xFFFF : repeat);
     return true;
+}
 
-#elif defined(__linux__)
-    Display* display = XOpenDisplay(nullptr);
-    if (!display) {
-        Logger::error("XOpenDisplay failed");
-        return false;
+// Відносний рух і прокрутка додаються до останньої неспожитої команди того ж
+// виду, MoveTo замінює попередній MoveTo. Злиття лише з останньою командою
+// не змінює порядку відносно кнопок і клавіш.
+bool mergeMotion(KeyCommand& into, const KeyCommand& from) {
+    if (into.action != from.action) return false;
+    switch (from.action) {
+    case KeyAction::PointerMove:
+    case KeyAction::Scroll: {
+        int64_t x = static_cast<int64_t>(into.x) + from.x;
+        int64_t y = static_cast<int64_t>(into.y) + from.y;
+        into.x = static_cast<int32_t>(std::max<int64_t>(INT32_MIN, std::min<int64_t>(INT32_MAX, x)));
+        into.y = static_cast<int32_t>(std::max<int64_t>(INT32_MIN, std::min<int64_t>(INT32_MAX, y)));
+        return true;
     }
-    int keycode = getKeyCodeX11(display, key);
-    if (keycode == -1) {
-        XCloseDisplay(display);
+    case KeyAction::PointerMoveTo:
+        into.x = from.x;
+        into.y = from.y;
+        return true;
+    default:
         return false;
     }
-    XTestFakeKeyEvent(display, keycode, True, CurrentTime);
-    XFlush(display);
-    usleep(50000);
-    XTestFakeKeyEvent(display, keycode, False, CurrentTime);
-    XFlush(display);
-    XCloseDisplay(display);
-    return true;
+}
 
-#elif defined(__APPLE__)
-    int keyCode = getKeyCode(key);
-    if (keyCode == -1) return false;
-    keyDown(keyCode);
-    usleep(50000);
-    keyUp(keyCode);
-    return true;
+// Черги одного виробника (мережевого потоку). Утримання й вказівник мають
+// свою чергу без викидання: рух після кнопки зсунув би клацання. Рух
+// зливається ще у виробника (mergeMotion), тож шквал touchmove не витісняє утримань
+// і не заповнює чергу. Політика з start() до неї не застосовується:
+// DropOldest і Coalesce викидали б натискання — вона завжди Backpressure.
+// Відпускання, що не вмістилося в повну ordered, не відкидається, а
+// додається до лічильника своєї клавіші чи кнопки: втрачене відпускання
+// лишило б клавішу затиснутою.
+struct ProducerQueues {
+    ProducerQueues(size_t capacity, OverflowPolicy policy, std::chrono::microseconds backpressureTimeout)
+        : taps(capacity, policy, &mergeCommands, backpressureTimeout),
+          ordered(capacity, OverflowPolicy::Backpressure, &mergeMotion, backpressureTimeout) {}
 
-#else
-    (void)key;
-    Logger::warning("Симуляція клавіатури не підтримується на цій платформі");
+    SpscQueue<KeyCommand> taps;
+    SpscQueue<KeyCommand> ordered;
+    std::atomic<uint32_t> keyReleases[keys::kKeyCount]{};
+    std::atomic<uint32_t> buttonReleases[kButtonCount]{};
+    std::atomic<bool> hasReleases{false};
+};
+
+// Стан потоку ін'єкції. Бекенд і кеш кодів клавіш належать лише цьому потоку;
+// команди надходять з мережевого потоку через lock-free чергу, м'ютекс
+// потрібен лише для засинання/пробудження споживача.
+struct Injector {
+    // По парі черг на кожен мережевий потік (шард); у кожної рівно один виробник
+    std::vector<std::unique_ptr<ProducerQueues>> commands;
+    std::chrono::microseconds tapHold{0};
+    std::chrono::microseconds pointerTick{8000};
+    std::chrono::microseconds backpressureTimeout{0};
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> sleeping{false};
+    std::thread thread;
+    std::atomic<bool> running{false};
+    bool ready = false;
+    std::atomic<bool> ok{false};
+    int keyCodes[keys::kKeyCount];
+    std::unique_ptr<InputBackend> backend; // змінюється лише без потоку
+
+    // Послідовності з injectSequence() — від будь-яких потоків, тож під mutex
+    std::vector<std::vector<KeyStep>> sequences;
+    std::atomic<bool> hasSequences{false};
+    uint64_t sequencesQueued = 0;
+    uint64_t sequencesDone = 0;
+    std::condition_variable sequencesCv;
+
+    // exit() з обробника сигналу: відпускаємо заплановані клавіші і чекаємо потік
+    ~Injector() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+            cv.notify_all();
+        }
+        if (thread.joinable())
+            thread.join();
+    }
+};
+
+Injector& injector() {
+    static Injector inj;
+    return inj;
+}
+
+void wakeInjector(Injector& inj) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (inj.sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(inj.mutex);
+        inj.cv.notify_one();
+    }
+}
+
+// Команда з будь-якої черги, по одній з кожної по колу, щоб шард
+// зі шквалом команд не затримував решту. next — з якої черги почати.
+bool popCommand(Injector& inj, KeyCommand& out, size_t& next) {
+    size_t count = inj.commands.size();
+    for (size_t i = 0; i < count; i++) {
+        size_t q = (next + i) % count;
+        if (inj.commands[q]->ordered.pop(out) || inj.commands[q]->taps.pop(out)) {
+            next = (q + 1) % count;
+            return true;
+        }
+    }
     return false;
-#endif
 }
 
-bool KeyboardSimulator::simulateKey(const std::string& keyName) {
-    ArrowKey key;
-    if (keyName == "up" || keyName == "UP") {
-        key = ArrowKey::UP;
-    } else if (keyName == "down" || keyName == "DOWN") {
-        key = ArrowKey::DOWN;
-    } else if (keyName == "left" || keyName == "LEFT") {
-        key = ArrowKey::LEFT;
-    } else if (keyName == "right" || keyName == "RIGHT") {
-        key = ArrowKey::RIGHT;
-    } else {
-        Logger::warning("Невідома команда: " + keyName);
-        return false;
+bool commandsEmpty(const Injector& inj) {
+    for (const auto& queues : inj.commands) {
+        if (!queues->ordered.empty() || !queues->taps.empty()) return false;
+        if (queues->hasReleases.load(std::memory_order_acquire)) return false;
     }
-    return simulateArrowKey(key);
+    return true;
 }
 
-#if defined(_WIN32)
-void KeyboardSimulator::keyDown(int) {}
-void KeyboardSimulator::keyUp(int) {}
-int KeyboardSimulator::getKeyCode(ArrowKey key) {
-    switch (key) {
-        case ArrowKey::UP:    return VK_UP;     // 0x26
-        case ArrowKey::DOWN:  return VK_DOWN;    // 0x28
-        case ArrowKey::LEFT:  return VK_LEFT;    // 0x25
-        case ArrowKey::RIGHT: return VK_RIGHT;   // 0x27
-        default: return -1;
+// Забирає відкладені відпускання всіх виробників як команди Release/ButtonUp.
+// Викликати до розбору черг, а застосовувати після: натискання, до якого
+// належить відпускання, стало в чергу раніше, ніж воно не вмістилося.
+void takeDeferredReleases(Injector& inj, std::vector<KeyCommand>& out) {
+    for (const auto& queues : inj.commands) {
+        if (!queues->hasReleases.exchange(false, std::memory_order_acquire)) continue;
+        KeyCommand cmd;
+        cmd.repeat = 1;
+        cmd.modifiers = 0;
+        for (uint16_t k = 0; k < keys::kKeyCount; k++) {
+            uint32_t n = queues->keyReleases[k].exchange(0, std::memory_order_relaxed);
+            cmd.key = k;
+            cmd.action = KeyAction::Release;
+            out.insert(out.end(), n, cmd);
+        }
+        for (uint16_t b = 1; b < kButtonCount; b++) {
+            uint32_t n = queues->buttonReleases[b].exchange(0, std::memory_order_relaxed);
+            cmd.key = b;
+            cmd.action = KeyAction::ButtonUp;
+            out.insert(out.end(), n, cmd);
+        }
     }
 }
+
+} // namespace
+
+bool KeyboardSimulator::start(size_t queueCapacity, OverflowPolicy policy, size_t producers) {
+    Injector& inj = injector();
+    std::unique_lock<std::mutex> lock(inj.mutex);
+    if (inj.running) return inj.ok;
+    if (!inj.backend) {
+        Logger::warning("Симуляція клавіатури не підтримується на цій платформі");
+        return false;
+    }
+    inj.commands.clear();
+    for (size_t i = 0; i < std::max<size_t>(producers, 1); i++)
+        inj.commands.emplace_back(new ProducerQueues(queueCapacity, policy, inj.backpressureTimeout));
+    inj.running = true;
+    inj.ready = false;
+#ifndef _WIN32
+    // Сигнали завершення викликають exit(), а ~Injector чекає цей потік: у ньому
+    // самому обробник не має виконуватися. Маска успадковується від творця.
+    sigset_t all, previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &previous);
+    inj.thread = std::thread(&KeyboardSimulator::workerLoop);
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+#else
+    inj.thread = std::thread(&KeyboardSimulator::workerLoop);
 #endif
+    inj.cv.wait(lock, [&inj] { return inj.ready; });
+    if (!inj.ok) {
+        lock.unlock();
+        stop();
+        return false;
+    }
+    return true;
+}
 
-#if defined(__linux__)
-void KeyboardSimulator::keyDown(int) {}
-void KeyboardSimulator::keyUp(int) {}
-static int getKeyCodeX11(Display* display, ArrowKey key) {
-    KeySym ks;
-    switch (key) {
-        case ArrowKey::UP:    ks = XK_Up;    break;
-        case ArrowKey::DOWN:  ks = XK_Down;  break;
-        case ArrowKey::LEFT:  ks = XK_Left;  break;
-        case ArrowKey::RIGHT: ks = XK_Right; break;
-        default: return -1;
+void KeyboardSimulator::setBackend(std::unique_ptr<InputBackend> backend) {
+    Injector& inj = injector();
+    std::lock_guard<std::mutex> lock(inj.mutex);
+    if (inj.running) {
+        Logger::error("Бекенд вводу не можна змінити під час роботи");
+        return;
     }
-    int kc = XKeysymToKeycode(display, ks);
-    return (kc != 0) ? kc : -1;
+    inj.backend = std::move(backend);
 }
 
-int KeyboardSimulator::getKeyCode(ArrowKey) {
-    return -1; // unused on Linux
+void KeyboardSimulator::setTapHold(std::chrono::microseconds hold) {
+    Injector& inj = injector();
+    std::lock_guard<std::mutex> lock(inj.mutex);
+    inj.tapHold = hold;
 }
-#endif
 
-#if defined(__APPLE__)
-void KeyboardSimulator::keyDown(int keyCode) {
-    CGEventRef keyDownEvent = CGEventCreateKeyboardEvent(nullptr, keyCode, true);
-    if (keyDownEvent) {
-        CGEventPost(kCGHIDEventTap, keyDownEvent);
-        CFRelease(keyDownEvent);
-    } else {
-        Logger::error("Помилка створення події натискання клавіші (код: " + std::to_string(keyCode) + ")");
+void KeyboardSimulator::setPointerTick(std::chrono::microseconds tick) {
+    Injector& inj = injector();
+    std::lock_guard<std::mutex> lock(inj.mutex);
+    inj.pointerTick = tick;
+}
+
+void KeyboardSimulator::setBackpressureTimeout(std::chrono::microseconds timeout) {
+    Injector& inj = injector();
+    std::lock_guard<std::mutex> lock(inj.mutex);
+    inj.backpressureTimeout = timeout;
+}
+
+void KeyboardSimulator::stop() {
+    Injector& inj = injector();
+    {
+        std::lock_guard<std::mutex> lock(inj.mutex);
+        inj.running = false;
+        inj.cv.notify_all();
     }
+    if (inj.thread.joinable())
+        inj.thread.join();
 }
 
-void KeyboardSimulator::keyUp(int keyCode) {
-    CGEventRef keyUpEvent = CGEventCreateKeyboardEvent(nullptr, keyCode, false);
-    if (keyUpEvent) {
-        CGEventPost(kCGHIDEventTap, keyUpEvent);
-        CFRelease(keyUpEvent);
+QueueStats KeyboardSimulator::queueStats() {
+    Injector& inj = injector();
+    QueueStats total = {0, 0, 0, 0};
+    for (const auto& queues : inj.commands) {
+        for (const SpscQueue<KeyCommand>* queue : {&queues->taps, &queues->ordered}) {
+            QueueStats qs = queue->stats();
+            total.enqueued += qs.enqueued;
+            total.dropped += qs.dropped;
+            total.coalesced += qs.coalesced;
+            total.highWater = std::max(total.highWater, qs.highWater);
+        }
+    }
+    return total;
+}
+
+bool KeyboardSimulator::enqueue(const KeyCommand& cmd, size_t producer) {
+    Injector& inj = injector();
+    if (!inj.running.load(std::memory_order_acquire) || !inj.ok) {
+        Logger::warning("Симуляція клавіатури недоступна");
+        return false;
+    }
+    if (producer >= inj.commands.size()) {
+        Logger::error("Немає черги команд для потоку " + std::to_string(producer));
+        return false;
+    }
+    ProducerQueues& queues = *inj.commands[producer];
+    bool accepted;
+    if (cmd.action == KeyAction::Tap) {
+        accepted = queues.taps.push(cmd);
     } else {
-        Logger::error("Помилка створення події відпускання клавіші (код: " + std::to_string(keyCode) + ")");
+        bool motion = cmd.action == KeyAction::PointerMove || cmd.action == KeyAction::PointerMoveTo
+                      || cmd.action == KeyAction::Scroll;
+        accepted = motion ? queues.ordered.pushMerged(cmd) : queues.ordered.push(cmd);
+        if (!accepted && cmd.action == KeyAction::Release && cmd.key < keys::kKeyCount) {
+            queues.keyReleases[cmd.key].fetch_add(1, std::memory_order_relaxed);
+            queues.hasReleases.store(true, std::memory_order_release);
+            accepted = true;
+        } else if (!accepted && cmd.action == KeyAction::ButtonUp && cmd.key < kButtonCount) {
+            queues.buttonReleases[cmd.key].fetch_add(1, std::memory_order_relaxed);
+            queues.hasReleases.store(true, std::memory_order_release);
+            accepted = true;
+        } else if (!accepted) {
+            Logger::error("Черга утримань і вказівника переповнена, команду втрачено");
+        }
     }
+    wakeInjector(inj);
+    return accepted;
+}
+
+bool KeyboardSimulator::simulateArrowKey(ArrowKey key) {
+    KeyCommand cmd;
+    cmd.key = static_cast<uint16_t>(key);
+    cmd.repeat = 1;
+    cmd.modifiers = 0;
+    return enqueue(cmd);
 }
 
-int KeyboardSimulator::getKeyCode(ArrowKey key) {
-    switch (key) {
-        case ArrowKey::UP:    return 126; // kVK_UpArrow
-        case ArrowKey::DOWN:  return 125; // kVK_DownArrow
-        case ArrowKey::LEFT:  return 123; // kVK_LeftArrow
-        case ArrowKey::RIGHT: return 124; // kVK_RightArrow
-        default: return -1;
+bool KeyboardSimulator::simulateKey(const std::string& keyName) {
+    keys::KeyId key = keys::find(keyName);
+    if (key == keys::kInvalidKey) {
+        Logger::warning("Невідома команда: " + keyName);
+        return false;
     }
+    KeyCommand cmd;
+    cmd.key = key;
+    cmd.repeat = 1;
+    cmd.modifiers = 0;
+    return enqueue(cmd);
+}
+
+bool KeyboardSimulator::injectSequence(const KeyStep* steps, size_t count) {
+    Injector& inj = injector();
+    if (!inj.running.load(std::memory_order_acquire) || !inj.ok) {
+        Logger::warning("Симуляція клавіатури недоступна");
+        return false;
+    }
+    if (count == 0) return true;
+    std::lock_guard<std::mutex> lock(inj.mutex);
+    inj.sequences.emplace_back(steps, steps + count);
+    inj.sequencesQueued++;
+    inj.hasSequences.store(true, std::memory_order_release);
+    inj.cv.notify_one();
+    return true;
+}
+
+void KeyboardSimulator::waitForSequences() {
+    Injector& inj = injector();
+    std::unique_lock<std::mutex> lock(inj.mutex);
+    uint64_t target = inj.sequencesQueued;
+    inj.sequencesCv.wait(lock, [&inj, target] { return inj.sequencesDone >= target; });
+}
+
+void KeyboardSimulator::workerLoop() {
+    Injector& inj = injector();
+    InputBackend& input = *inj.backend;
+    bool ok = input.open();
+    Clock::duration tapHold;
+    Clock::duration pointerTick;
+    {
+        std::lock_guard<std::mutex> lock(inj.mutex);
+        for (int k = 0; k < keys::kKeyCount; k++)
+            inj.keyCodes[k] = ok ? input.keyCode(static_cast<keys::KeyId>(k)) : -1;
+        tapHold = inj.tapHold;
+        pointerTick = inj.pointerTick;
+        inj.ok = ok;
+        inj.ready = true;
+        inj.cv.notify_all();
+    }
+    if (!ok) return;
+
+    // Розклад натискань/відпускань належить лише цьому потоку
+    std::priority_queue<KeyEvent, std::vector<KeyEvent>, LaterFirst> events;
+    std::unordered_map<int, Clock::time_point> releaseDue; // останнє заплановане відпускання
+    std::unordered_map<int, int> heldCount; // скільки утримань (від різних з'єднань) на клавішу
+    int buttonHeld[kButtonCount] = {};
+    PendingPointer pointer;
+    Clock::time_point pointerFlushed;
+    uint64_t seq = 0;
+    size_t nextQueue = 0;
+    std::vector<std::vector<KeyStep>> sequences;
+    std::vector<int> held;
+    std::vector<latency::Timing> injectedTimings;
+    std::vector<KeyCommand> deferredReleases;
+
+    for (;;) {
+        bool running = inj.running.load(std::memory_order_acquire);
+
+        // Повторні натискання тієї ж клавіші не перекриваються: нове
+        // натискання починається після запланованого відпускання попереднього.
+        // Модифікатори натискаються до клавіші і відпускаються після неї.
+        // Накопичений рух стає подіями перед будь-якою іншою командою і раз на тік
+        auto flushPointer = [&](Clock::time_point at) {
+            if (pointer.moveTo) events.push({-1, false, at, seq++, {}, EventKind::MoveTo, pointer.toX, pointer.toY});
+            if (pointer.dx || pointer.dy) events.push({-1, false, at, seq++, {}, EventKind::Move, pointer.dx, pointer.dy});
+            if (pointer.scrollX || pointer.scrollY)
+                events.push({-1, false, at, seq++, {}, EventKind::Scroll, pointer.scrollX, pointer.scrollY});
+            pointer = PendingPointer();
+            pointerFlushed = at;
+        };
+
+        auto handleCommand = [&](const KeyCommand& cmd) {
+            switch (cmd.action) {
+            case KeyAction::PointerMove:
+                pointer.dx = addClamped(pointer.dx, cmd.x, kMaxMoveDelta);
+                pointer.dy = addClamped(pointer.dy, cmd.y, kMaxMoveDelta);
+                return;
+            case KeyAction::Scroll:
+                pointer.scrollX = addClamped(pointer.scrollX, cmd.x, kMaxScrollClicks);
+                pointer.scrollY = addClamped(pointer.scrollY, cmd.y, kMaxScrollClicks);
+                return;
+            case KeyAction::PointerMoveTo:
+                // Абсолютна позиція скасовує відносний рух до неї, але не
+                // прокрутку: та має статися там, де курсор був
+                if (pointer.scrollX || pointer.scrollY) flushPointer(Clock::now());
+                pointer.moveTo = true;
+                pointer.toX = cmd.x;
+                pointer.toY = cmd.y;
+                pointer.dx = pointer.dy = 0;
+                return;
+            default:
+                break;
+            }
+            if (!pointer.empty()) flushPointer(Clock::now());
+            if (cmd.action == KeyAction::ButtonDown || cmd.action == KeyAction::ButtonUp) {
+                if (cmd.key == 0 || cmd.key >= kButtonCount) return;
+                bool press = cmd.action == KeyAction::ButtonDown;
+                int& count = buttonHeld[cmd.key];
+                if (press ? count++ == 0 : (count > 0 && --count == 0))
+                    events.push({cmd.key, press, Clock::now(), seq++, press ? cmd.timing : latency::Timing(),
+                                 EventKind::Button});
+                return;
+            }
+
+            int keyCode = cmd.key < keys::kKeyCount ? inj.keyCodes[cmd.key] : -1;
+            if (keyCode == -1) return;
+            // Утримувану кількома клієнтами клавішу система бачить натиснутою
+            // від першого Press до останнього Release
+            if (cmd.action == KeyAction::Press) {
+                if (heldCount[keyCode]++ == 0)
+                    events.push({keyCode, true, Clock::now(), seq++, cmd.timing, EventKind::Held});
+                return;
+            }
+            if (cmd.action == KeyAction::Release) {
+                auto it = heldCount.find(keyCode);
+                if (it != heldCount.end() && --it->second == 0) {
+                    heldCount.erase(it);
+                    events.push({keyCode, false, Clock::now(), seq++, {}, EventKind::Held});
+                }
+                return;
+            }
+            int modCodes[4];
+            int modCount = 0;
+            for (int m = 0; m < 4; m++) {
+                if ((cmd.modifiers & (1 << m)) && inj.keyCodes[kModifierKeys[m]] != -1)
+                    modCodes[modCount++] = inj.keyCodes[kModifierKeys[m]];
+            }
+            for (uint16_t r = 0; r < cmd.repeat; r++) {
+                Clock::time_point pressAt = Clock::now();
+                auto it = releaseDue.find(keyCode);
+                if (it != releaseDue.end() && it->second > pressAt)
+                    pressAt = it->second;
+                Clock::time_point releaseAt = pressAt + tapHold;
+                releaseDue[keyCode] = releaseAt;
+                for (int m = 0; m < modCount; m++)
+                    events.push({modCodes[m], true, pressAt, seq++, {}, EventKind::Synthetic});
+                events.push({keyCode, true, pressAt, seq++, r == 0 ? cmd.timing : latency::Timing(),
+                             EventKind::Synthetic});
+                events.push({keyCode, false, releaseAt, seq++, {}, EventKind::Synthetic});
+                for (int m = modCount - 1; m >= 0; m--)
+                    events.push({modCodes[m], false, releaseAt, seq++, {}, EventKind::Synthetic});
+            }
+        };
+
+        takeDeferredReleases(inj, deferredReleases);
+        KeyCommand cmd;
+        while (popCommand(inj, cmd, nextQueue)) handleCommand(cmd);
+        for (const KeyCommand& release : deferredReleases) handleCommand(release);
+        deferredReleases.clear();
+
+        // Кроки послідовності до паузи мають однаковий час, тож виконуються
+        // одним проходом нижче і одним flush()
+        if (inj.hasSequences.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(inj.mutex);
+            sequences.swap(inj.sequences);
+            inj.hasSequences.store(false, std::memory_order_relaxed);
+        }
+        for (const auto& steps : sequences) {
+            Clock::time_point at = Clock::now();
+            held.clear();
+            for (const KeyStep& step : steps) {
+                if (step.action == KeyStep::Delay) {
+                    at += std::chrono::microseconds(step.delayUs);
+                    continue;
+                }
+                int keyCode = step.key < keys::kKeyCount ? inj.keyCodes[step.key] : -1;
+                if (keyCode == -1) continue;
+                bool press = step.action == KeyStep::Press;
+                if (press) {
+                    held.push_back(keyCode);
+                } else {
+                    auto it = std::find(held.begin(), held.end(), keyCode);
+                    if (it != held.end()) held.erase(it);
+                }
+                events.push({keyCode, press, at, seq++, {}, EventKind::Synthetic});
+            }
+            for (auto it = held.rbegin(); it != held.rend(); ++it)
+                events.push({*it, false, at, seq++, {}, EventKind::Synthetic});
+            events.push({-1, false, at, seq++, {}, EventKind::SequenceEnd});
+        }
+        sequences.clear();
+
+        Clock::time_point now = Clock::now();
+        if (!pointer.empty() && (!running || now - pointerFlushed >= pointerTick)) flushPointer(now);
+
+        // Виконуємо всі події, час яких настав (при зупинці — усі, щоб не лишити
+        // затиснутих клавіш), і передаємо їх системі однією пачкою.
+        bool injected = false;
+        uint64_t sequencesDone = 0;
+        while (!events.empty() && (!running || events.top().due <= now)) {
+            const KeyEvent& ev = events.top();
+            if (ev.kind == EventKind::SequenceEnd) {
+                sequencesDone++;
+            } else if (ev.kind == EventKind::Move || ev.kind == EventKind::MoveTo || ev.kind == EventKind::Scroll) {
+                if (ev.kind == EventKind::Move) input.moveBy(ev.x, ev.y);
+                else if (ev.kind == EventKind::MoveTo) input.moveTo(ev.x, ev.y);
+                else input.scroll(ev.x, ev.y);
+                injected = true;
+            } else if (ev.kind == EventKind::Button) {
+                input.button(ev.keyCode, ev.press);
+                if (ev.timing.readable) injectedTimings.push_back(ev.timing);
+                injected = true;
+            } else if (ev.kind == EventKind::Synthetic && heldCount.count(ev.keyCode)) {
+                // Клієнт утримує цю клавішу: натискання не має її відпустити
+            } else if (ev.press) {
+                input.keyDown(ev.keyCode);
+                if (ev.timing.readable) injectedTimings.push_back(ev.timing);
+                injected = true;
+            } else {
+                input.keyUp(ev.keyCode);
+                injected = true;
+            }
+            events.pop();
+        }
+        if (injected) {
+            input.flush();
+            uint64_t flushedAt = latency::now();
+            for (const latency::Timing& t : injectedTimings) latency::recordInjection(t, flushedAt);
+            injectedTimings.clear();
+            if (events.empty()) releaseDue.clear();
+        }
+        if (sequencesDone) {
+            std::lock_guard<std::mutex> lock(inj.mutex);
+            inj.sequencesDone += sequencesDone;
+            inj.sequencesCv.notify_all();
+        }
+        if (!running) break;
+
+        std::unique_lock<std::mutex> lock(inj.mutex);
+        inj.sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (commandsEmpty(inj) && inj.sequences.empty() && inj.running.load(std::memory_order_relaxed)) {
+            Clock::time_point wakeAt = Clock::time_point::max();
+            if (!events.empty()) wakeAt = events.top().due;
+            if (!pointer.empty()) wakeAt = std::min(wakeAt, pointerFlushed + pointerTick);
+            if (wakeAt == Clock::time_point::max()) inj.cv.wait(lock);
+            else inj.cv.wait_until(lock, wakeAt);
+        }
+        inj.sleeping.store(false, std::memory_order_relaxed);
+    }
+
+    // Клієнти, що ще утримують клавіші й кнопки, вже не відпустять їх
+    bool released = !heldCount.empty();
+    for (const auto& held : heldCount) input.keyUp(held.first);
+    for (int b = 1; b < kButtonCount; b++) {
+        if (buttonHeld[b] == 0) continue;
+        input.button(b, false);
+        released = true;
+    }
+    if (released) input.flush();
+
+    {
+        // Послідовності, що надійшли після останнього проходу, вже не виконаються
+        std::lock_guard<std::mutex> lock(inj.mutex);
+        inj.ok = false;
+        inj.sequences.clear();
+        inj.hasSequences.store(false, std::memory_order_relaxed);
+        inj.sequencesDone = inj.sequencesQueued;
+        inj.sequencesCv.notify_all();
+    }
+    input.close();
 }
-#endif
@@ -1,25 +1,121 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include "input_backend.h"
+#include "key_table.h"
+#include "latency_stats.h"
+#include "spsc_queue.h"
+
+enum class KeyAction : uint8_t {
+    Tap,            // натиснути й відпустити (repeat разів, з модифікаторами)
+    Press,          // утримувати до Release; клавіша відпускається, коли її відпустили всі
+    Release,
+    // Вказівник. Відносний рух і прокрутка накопичуються й вводяться не
+    // частіше за раз на setPointerTick(); кнопки, клавіші та MoveTo спершу
+    // вводять накопичене, тож клацання потрапляє туди, куди дійшов курсор.
+    PointerMove,    // x, y — зсув у пікселях
+    PointerMoveTo,  // x, y — 0..65535 від ширини й висоти екрана
+    ButtonDown,     // key — MouseButton; утримання рахуються як у Press
+    ButtonUp,
+    Scroll          // x, y — клацання коліщатка; y > 0 — вниз, x > 0 — праворуч
+};
+
+// Команда від мережевого потоку до потоку ін'єкції
+struct KeyCommand {
+    uint16_t key;       // keys::KeyId або MouseButton
+    uint16_t repeat;    // скільки разів натиснути (зростає при злитті в черзі)
+    uint8_t modifiers;  // proto::Modifier
+    KeyAction action = KeyAction::Tap;
+    int32_t x = 0;      // лише для вказівника
+    int32_t y = 0;
+    latency::Timing timing; // при злитті лишаються мітки старшої команди
+};
+
+// Крок послідовності для KeyboardSimulator::injectSequence()
+struct KeyStep {
+    enum Action : uint8_t {
+        Press,
+        Release,
+        Delay
+    };
+    Action action;
+    uint16_t key;      // keys::KeyId для Press/Release
+    uint32_t delayUs;  // для Delay: пауза перед наступними кроками
+
+    static KeyStep press(uint16_t key) { return {Press, key, 0}; }
+    static KeyStep release(uint16_t key) { return {Release, key, 0}; }
+    static KeyStep delay(std::chrono::microseconds d) { return {Delay, 0, static_cast<uint32_t>(d.count())}; }
+};
 
 class KeyboardSimulator {
 public:
     enum class ArrowKey {
-        UP,
-        DOWN,
-        LEFT,
-        RIGHT
+        UP = keys::KeyUp,
+        DOWN = keys::KeyDown,
+        LEFT = keys::KeyLeft,
+        RIGHT = keys::KeyRight
     };
 
-    // Симулює натискання стрілочки
+    static const size_t kDefaultQueueCapacity = 256;
+
+    // Бекенд вводу (createPlatformInputBackend(), RecordingBackend...);
+    // задати до start(), лишається й після stop()
+    static void setBackend(std::unique_ptr<InputBackend> backend);
+
+    // Запускає потік ін'єкції: відкриває бекенд (постійне з'єднання з
+    // дисплеєм) і будує кеш кодів клавіш. Повертає false, якщо бекенд
+    // не задано або він недоступний.
+    // Команди передаються через SPSC-черги з заданою політикою переповнення,
+    // по одній на кожного з producers виробників (мережевих потоків).
+    // Усе, крім Tap, іде окремою чергою без злиття й викидання.
+    static bool start(size_t queueCapacity = kDefaultQueueCapacity,
+                      OverflowPolicy policy = OverflowPolicy::Coalesce,
+                      size_t producers = 1);
+    // Зупиняє потік, попередньо відпустивши всі заплановані й утримувані клавіші.
+    static void stop();
+
+    // Скільки клавіша утримується при KeyAction::Tap; 0 — натискання й
+    // відпускання однією пачкою. Викликати до start().
+    static void setTapHold(std::chrono::microseconds hold);
+    // Найменший інтервал між вводами накопиченого руху вказівника;
+    // 0 — вводити на кожному проході потоку. Викликати до start().
+    static void setPointerTick(std::chrono::microseconds tick);
+    // Скільки enqueue() чекає на місце в повній черзі з OverflowPolicy::Backpressure;
+    // 0 (за замовчуванням) — не чекати. Викликати до start().
+    static void setBackpressureTimeout(std::chrono::microseconds timeout);
+
+    // Сума по всіх чергах; highWater — найбільший з них
+    static QueueStats queueStats();
+
+    // Ставить команду в чергу виробника producer (0..producers-1) і одразу
+    // повертається. Кожна черга однопродюсерна: для одного номера викликати
+    // лише з одного (мережевого) потоку.
+    // Мережевий потік тут не блокується: у повній черзі Tap діє політика з
+    // start(), а черга утримань і вказівника працює як Backpressure, тобто
+    // чекає не довше за setBackpressureTimeout() і за замовчуванням одразу
+    // відкидає команду. Release і ButtonUp не відкидаються ніколи: якщо черга
+    // повна, вони виконуються після вже поставлених команд цього виробника.
+    // false — команду відкинуто.
+    static bool enqueue(const KeyCommand& cmd, size_t producer = 0);
+
+    // Ставить у чергу натискання стрілочки
     static bool simulateArrowKey(ArrowKey key);
-    
-    // Симулює натискання клавіші за її назвою
+
+    // Симулює натискання клавіші за її назвою (див. key_table.h, регістр не важливий)
     static bool simulateKey(const std::string& keyName);
-    
+
+    // Макрос або серія натискань: кроки між паузами виконуються разом і
+    // скидаються одним XFlush / SendInput / серією CGEventPost. Клавіші, не
+    // відпущені до кінця послідовності, відпускаються після неї.
+    // Можна викликати з будь-якого потоку.
+    static bool injectSequence(const KeyStep* steps, size_t count);
+    // Чекає, поки виконано всі послідовності, поставлені до виклику
+    static void waitForSequences();
+
 private:
-    // Внутрішні методи для роботи з Core Graphics
-    static void keyDown(int keyCode);
-    static void keyUp(int keyCode);
-    static int getKeyCode(ArrowKey key);
+    static void workerLoop();
 };
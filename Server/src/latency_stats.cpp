@@ -0,0 +1,142 @@
+#include "latency_stats.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace latency {
+
+namespace {
+
+int highestBit(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, v);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+Histogram& stageHistogram(Stage stage) {
+    static Histogram histograms[kStageCount];
+    return histograms[stage];
+}
+
+void appendMicros(std::string& out, const char* label, uint64_t ns) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), " %s=%.1fus", label, static_cast<double>(ns) / 1000.0);
+    out += buf;
+}
+
+} // namespace
+
+uint64_t now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+Timing& current() {
+    thread_local Timing timing;
+    return timing;
+}
+
+Histogram::Histogram() : count_(0), max_(0) {
+    for (int i = 0; i < kBucketCount; i++)
+        buckets_[i].store(0, std::memory_order_relaxed);
+}
+
+int Histogram::bucketIndex(uint64_t value) {
+    if (value < static_cast<uint64_t>(kSubCount)) return static_cast<int>(value);
+    int e = highestBit(value);
+    if (e > kMaxExponent) return kBucketCount - 1;
+    int sub = static_cast<int>((value >> (e - kSubBits)) & (kSubCount - 1));
+    return kSubCount + (e - kSubBits) * kSubCount + sub;
+}
+
+uint64_t Histogram::bucketUpperBound(int index) {
+    if (index < kSubCount) return static_cast<uint64_t>(index);
+    int k = index - kSubCount;
+    int shift = k / kSubCount;
+    uint64_t lower = static_cast<uint64_t>(kSubCount + k % kSubCount) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+    buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t prev = max_.load(std::memory_order_relaxed);
+    while (value > prev && !max_.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t Histogram::percentile(double q) const {
+    // Кошики читаються по одному, тож під час запису знімок може бути
+    // трохи неузгодженим — для статистики цього достатньо
+    uint64_t counts[kBucketCount];
+    uint64_t total = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) return 0;
+    uint64_t target = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total)));
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        seen += counts[i];
+        if (seen >= target) {
+            uint64_t bound = bucketUpperBound(i);
+            uint64_t m = max();
+            return bound < m ? bound : m;
+        }
+    }
+    return max();
+}
+
+const Histogram& histogram(Stage stage) {
+    return stageHistogram(stage);
+}
+
+const char* stageName(Stage stage) {
+    switch (stage) {
+        case StageDecode: return "decode";
+        case StageDispatch: return "dispatch";
+        case StageInject: return "inject";
+        case StageTotal: return "total";
+        default: return "unknown";
+    }
+}
+
+void recordInjection(const Timing& t, uint64_t injected) {
+    if (t.readable == 0) return;
+    if (t.decoded >= t.readable)
+        stageHistogram(StageDecode).record(t.decoded - t.readable);
+    if (t.dispatched >= t.decoded && t.decoded != 0)
+        stageHistogram(StageDispatch).record(t.dispatched - t.decoded);
+    if (injected >= t.dispatched && t.dispatched != 0)
+        stageHistogram(StageInject).record(injected - t.dispatched);
+    if (injected >= t.readable)
+        stageHistogram(StageTotal).record(injected - t.readable);
+}
+
+std::string summary() {
+    std::string out;
+    for (int s = 0; s < kStageCount; s++) {
+        const Histogram& h = stageHistogram(static_cast<Stage>(s));
+        if (!out.empty()) out += ";";
+        out += " ";
+        out += stageName(static_cast<Stage>(s));
+        out += " n=" + std::to_string(h.count());
+        appendMicros(out, "p50", h.percentile(0.50));
+        appendMicros(out, "p99", h.percentile(0.99));
+        appendMicros(out, "p999", h.percentile(0.999));
+        appendMicros(out, "max", h.max());
+    }
+    return out.empty() ? out : out.substr(1);
+}
+
+} // namespace latency
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Наскрізна затримка команди: від моменту, коли сокет став читабельним,
+// до передачі події системі (XFlush/SendInput/CGEventPost).
+// Усі значення — наносекунди монотонного годинника.
+namespace latency {
+
+enum Stage {
+    StageDecode,    // сокет читабельний -> кадр розібрано (decodeWebSocketFrame)
+    StageDispatch,  // кадр розібрано -> обробник команди (handleMessage)
+    StageInject,    // обробник -> виклик ін'єкції повернувся (разом з чергою)
+    StageTotal,     // сокет читабельний -> виклик ін'єкції повернувся
+    kStageCount
+};
+
+// Мітки однієї команди; 0 — точку не пройдено (наприклад, команда не з мережі)
+struct Timing {
+    uint64_t readable = 0;
+    uint64_t decoded = 0;
+    uint64_t dispatched = 0;
+};
+
+uint64_t now();
+
+// Мітки повідомлення, яке мережевий потік обробляє в цю мить
+Timing& current();
+
+// Лог-лінійна гістограма (як HDR): 32 під-кошики на кожен степінь двійки,
+// відносна похибка не більше ~3%. Запис — один relaxed fetch_add,
+// тож писати і читати можна з будь-яких потоків без блокувань.
+class Histogram {
+public:
+    static const int kSubBits = 5;
+    static const int kSubCount = 1 << kSubBits;
+    static const int kMaxExponent = 40;  // значення до 2^41 нс (~36 хв)
+    static const int kBucketCount = kSubCount + (kMaxExponent - kSubBits + 1) * kSubCount;
+
+    Histogram();
+
+    void record(uint64_t value);
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    // Верхня межа кошика, в який потрапляє квантиль q (0..1)
+    uint64_t percentile(double q) const;
+
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(int index);
+
+private:
+    std::atomic<uint64_t> buckets_[kBucketCount];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> max_;
+};
+
+const Histogram& histogram(Stage stage);
+const char* stageName(Stage stage);
+
+// Записує всі етапи команди, ін'єкція якої завершилась у момент injected
+void recordInjection(const Timing& t, uint64_t injected);
+
+// Рядок з p50/p99/p999/max по кожному етапу, у мікросекундах
+std::string summary();
+
+} // namespace latency
@@ -1,22 +1,363 @@
 #include "logger.h"
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
 
-std::ofstream Logger::logFile_;
-std::mutex Logger::mutex_;
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const size_t kSlotCount = 1024;     // степінь двійки
+const size_t kMaxLine = 496;        // довші повідомлення обрізаються
+const size_t kBatch = 64;           // записів на один writev()
+
+// Біти State::timestampMode
+const uint32_t kPrecisionMask = 0x3;   // Logger::TimestampPrecision
+const uint32_t kModeUtc = 1 << 2;
+const uint32_t kModeMonotonic = 1 << 3;
+
+// Комірка черги: seq == pos — вільна для позиції pos, seq == pos + 1 — заповнена
+struct alignas(64) Slot {
+    std::atomic<uint64_t> seq;
+    uint32_t len;
+    char data[kMaxLine];
+};
+
+struct State {
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<uint64_t> tail{0};          // наступна позиція для виробників
+    alignas(64) std::atomic<uint64_t> pendingBytes{0};
+    std::atomic<uint64_t> dropped{0};
+    alignas(64) uint64_t head = 0;                      // лише потік запису
+    std::atomic<uint64_t> flushed{0};                   // усі позиції < flushed записані
+
+    std::mutex mutex;
+    std::mutex fdMutex;                // дескриптор міняється лише між пачками
+    std::condition_variable wake;      // будить потік запису
+    std::condition_variable flushedCv; // сигналізує про завершений запис
+    bool flushRequested = false;
+    bool stopping = false;
+    std::atomic<bool> running{false};
+    std::thread writer;
+    int fd = -1;
+
+    std::atomic<int64_t> intervalMs{100};
+    std::atomic<uint64_t> thresholdBytes{16 * 1024};
+
+    std::atomic<uint32_t> timestampMode{static_cast<uint32_t>(Logger::TimestampPrecision::Milliseconds)};
+    std::atomic<int64_t> monotonicOffsetUs{0};  // system_clock - steady_clock
+
+    State() : slots(new Slot[kSlotCount]) {
+        for (size_t i = 0; i < kSlotCount; i++)
+            slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+};
+
+State& state() {
+    static State s;
+    return s;
+}
+
+// Останнє відформатоване значення секунди; кожен потік має власне
+struct TimestampCache {
+    int64_t second = -1;
+    uint32_t mode = ~0u;
+    size_t len = 0;
+    char text[Logger::kTimestampSize];
+};
+
+int64_t microsSinceEpoch(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch()).count();
+}
+
+int64_t microsSinceEpoch(std::chrono::system_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch()).count();
+}
+
+int openLog(const std::string& path) {
+#ifdef _WIN32
+    return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+}
+
+void closeLog(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
+
+void writeAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+#ifdef _WIN32
+        int n = _write(fd, data, static_cast<unsigned int>(len));
+#else
+        ssize_t n = write(fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        if (n <= 0) return;
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+}
+
+// Пише kBatch або менше заповнених комірок, починаючи з head, одним викликом
+size_t writeBatch(State& s) {
+    Slot* ready[kBatch];
+    size_t count = 0;
+    size_t bytes = 0;
+    while (count < kBatch) {
+        uint64_t pos = s.head + count;
+        Slot& slot = s.slots[pos & (kSlotCount - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != pos + 1) break;
+        ready[count++] = &slot;
+        bytes += slot.len;
+    }
+    if (count == 0) return 0;
+
+    if (s.fd != -1) {
+#ifdef _WIN32
+        std::string joined;
+        joined.reserve(bytes);
+        for (size_t i = 0; i < count; i++)
+            joined.append(ready[i]->data, ready[i]->len);
+        writeAll(s.fd, joined.data(), joined.size());
+#else
+        struct iovec iov[kBatch];
+        for (size_t i = 0; i < count; i++) {
+            iov[i].iov_base = ready[i]->data;
+            iov[i].iov_len = ready[i]->len;
+        }
+        struct iovec* cur = iov;
+        int left = static_cast<int>(count);
+        while (left > 0) {
+            ssize_t n = writev(s.fd, cur, left);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            // Часткий запис: пропускаємо повністю записані iovec, решту дописуємо
+            size_t done = static_cast<size_t>(n);
+            while (left > 0 && done >= cur->iov_len) {
+                done -= cur->iov_len;
+                cur++;
+                left--;
+            }
+            if (left > 0 && done > 0) {
+                cur->iov_base = static_cast<char*>(cur->iov_base) + done;
+                cur->iov_len -= done;
+            }
+        }
+#endif
+    }
+
+    for (size_t i = 0; i < count; i++)
+        ready[i]->seq.store(s.head + i + kSlotCount, std::memory_order_release);
+    s.head += count;
+    s.pendingBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    return count;
+}
+
+} // namespace
 
 void Logger::init(const std::string& logPath) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (logFile_.is_open()) {
-        logFile_.close();
+    State& s = state();
+    int fd = openLog(logPath);
+    {
+        std::unique_lock<std::mutex> lock(s.mutex);
+        if (s.running) {
+            // Дописуємо чергу в старий файл, потім підміняємо дескриптор
+            uint64_t target = s.tail.load(std::memory_order_acquire);
+            s.flushRequested = true;
+            s.wake.notify_one();
+            s.flushedCv.wait(lock, [&s, target] { return s.flushed.load() >= target; });
+            std::lock_guard<std::mutex> fdLock(s.fdMutex);
+            if (s.fd != -1) closeLog(s.fd);
+            s.fd = fd;
+            return;
+        }
+        s.fd = fd;
+        s.stopping = false;
+        s.running = true;
+#ifndef _WIN32
+        // exit() з обробника сигналу чекає цей потік у shutdown(), тож сигнали
+        // мають приходити в інші потоки
+        sigset_t all, previous;
+        sigfillset(&all);
+        pthread_sigmask(SIG_BLOCK, &all, &previous);
+        s.writer = std::thread(&Logger::writerLoop);
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+#else
+        s.writer = std::thread(&Logger::writerLoop);
+#endif
+    }
+    static bool registered = false;
+    if (!registered) {
+        registered = true;
+        std::atexit(&Logger::shutdown);
     }
-    logFile_.open(logPath, std::ios::app);
+}
+
+void Logger::shutdown() {
+    State& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (!s.running) return;
+        s.stopping = true;
+        s.wake.notify_one();
+    }
+    if (s.writer.joinable())
+        s.writer.join();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.running = false;
+        if (s.fd != -1) {
+            closeLog(s.fd);
+            s.fd = -1;
+        }
+    }
+    s.flushedCv.notify_all();
+}
+
+void Logger::setBatching(std::chrono::milliseconds flushInterval, size_t thresholdBytes) {
+    State& s = state();
+    s.intervalMs.store(flushInterval.count(), std::memory_order_relaxed);
+    s.thresholdBytes.store(thresholdBytes, std::memory_order_relaxed);
 }
 
 void Logger::log(Level level, const std::string& message) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (logFile_.is_open()) {
-        logFile_ << "[" << getTimestamp() << "] [" << levelToString(level) << "] " << message << std::endl;
-        logFile_.flush();
+    State& s = state();
+    if (!s.running.load(std::memory_order_acquire)) return;
+
+    // Форматуємо у власний буфер потоку, щоб комірка черги займалася лише на memcpy
+    thread_local char line[kMaxLine];
+    line[0] = '[';
+    size_t len = 1 + formatTimestamp(line + 1);
+    int prefix = snprintf(line + len, sizeof(line) - len, "] [%s] ", levelToString(level));
+    len += static_cast<size_t>(std::max(prefix, 0));
+    size_t room = kMaxLine - 1 - len;
+    size_t msgLen = std::min(message.size(), room);
+    if (msgLen < message.size()) {
+        // Не розрізаємо багатобайтовий символ UTF-8
+        while (msgLen > 0 && (static_cast<unsigned char>(message[msgLen]) & 0xC0) == 0x80)
+            msgLen--;
+    }
+    std::memcpy(line + len, message.data(), msgLen);
+    len += msgLen;
+    if (msgLen < message.size() && len >= 3)
+        std::memcpy(line + len - 3, "...", 3);
+    line[len++] = '\n';
+
+    // Захоплюємо комірку (Vyukov MPSC). При переповненні INFO/WARN відкидаються,
+    // ERROR чекає на місце.
+    uint64_t pos = s.tail.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &s.slots[pos & (kSlotCount - 1)];
+        uint64_t seq = slot->seq.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (s.tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            if (level != Level::ERROR) {
+                s.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            s.wake.notify_one();
+            std::this_thread::yield();
+            pos = s.tail.load(std::memory_order_relaxed);
+        } else {
+            pos = s.tail.load(std::memory_order_relaxed);
+        }
+    }
+    std::memcpy(slot->data, line, len);
+    slot->len = static_cast<uint32_t>(len);
+    slot->seq.store(pos + 1, std::memory_order_release);
+
+    uint64_t threshold = s.thresholdBytes.load(std::memory_order_relaxed);
+    uint64_t before = s.pendingBytes.fetch_add(len, std::memory_order_relaxed);
+
+    if (level == Level::ERROR) {
+        std::unique_lock<std::mutex> lock(s.mutex);
+        s.flushRequested = true;
+        s.wake.notify_one();
+        s.flushedCv.wait(lock, [&s, pos] {
+            return s.flushed.load(std::memory_order_acquire) > pos || !s.running;
+        });
+    } else if (before < threshold && before + len >= threshold) {
+        s.wake.notify_one();
+    }
+}
+
+void Logger::writerLoop() {
+    State& s = state();
+    for (;;) {
+        bool stop;
+        bool urgent;
+        {
+            std::unique_lock<std::mutex> lock(s.mutex);
+            s.wake.wait_for(lock, std::chrono::milliseconds(s.intervalMs.load(std::memory_order_relaxed)), [&s] {
+                return s.flushRequested || s.stopping
+                    || s.pendingBytes.load(std::memory_order_relaxed) >= s.thresholdBytes.load(std::memory_order_relaxed);
+            });
+            stop = s.stopping;
+            urgent = s.flushRequested || stop;
+            s.flushRequested = false;
+        }
+
+        std::unique_lock<std::mutex> fdLock(s.fdMutex);
+
+        uint64_t dropped = s.dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped && s.fd != -1) {
+            char note[160];
+            note[0] = '[';
+            size_t len = 1 + formatTimestamp(note + 1);
+            int n = snprintf(note + len, sizeof(note) - len,
+                             "] [WARN] Логер: пропущено записів через переповнення черги: %llu\n",
+                             static_cast<unsigned long long>(dropped));
+            writeAll(s.fd, note, len + static_cast<size_t>(std::max(n, 0)));
+        }
+
+        // Дописуємо все, що встигло з'явитися. Записи, які виробник ще копіює
+        // в комірку, чекаємо лише при ERROR/зупинці — інакше заберемо їх наступного разу.
+        uint64_t target = s.tail.load(std::memory_order_acquire);
+        while (s.head < target) {
+            if (writeBatch(s) == 0) {
+                if (!urgent) break;
+                std::this_thread::yield();
+            }
+        }
+        fdLock.unlock();
+
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.flushed.store(s.head, std::memory_order_release);
+        }
+        s.flushedCv.notify_all();
+        if (stop) return;
     }
 }
 
@@ -32,7 +373,7 @@ void Logger::error(const std::string& message) {
     log(Level::ERROR, message);
 }
 
-std::string Logger::levelToString(Level level) {
+const char* Logger::levelToString(Level level) {
     switch (level) {
         case Level::INFO: return "INFO";
         case Level::WARNING: return "WARN";
@@ -41,11 +382,79 @@ std::string Logger::levelToString(Level level) {
     }
 }
 
-std::string Logger::getTimestamp() {
-    auto now = std::time(nullptr);
-    auto tm = *std::localtime(&now);
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+void Logger::setTimestampPrecision(TimestampPrecision precision) {
+    State& s = state();
+    uint32_t mode = s.timestampMode.load(std::memory_order_relaxed);
+    while (!s.timestampMode.compare_exchange_weak(
+        mode, (mode & ~kPrecisionMask) | static_cast<uint32_t>(precision), std::memory_order_relaxed)) {
+    }
+}
+
+void Logger::setUtcTimestamps(bool enabled) {
+    State& s = state();
+    if (enabled) s.timestampMode.fetch_or(kModeUtc, std::memory_order_relaxed);
+    else s.timestampMode.fetch_and(~kModeUtc, std::memory_order_relaxed);
+}
+
+void Logger::setMonotonicTimestamps(bool enabled) {
+    State& s = state();
+    if (enabled) {
+        int64_t offset = microsSinceEpoch(std::chrono::system_clock::now())
+                       - microsSinceEpoch(std::chrono::steady_clock::now());
+        s.monotonicOffsetUs.store(offset, std::memory_order_relaxed);
+        s.timestampMode.fetch_or(kModeMonotonic, std::memory_order_release);
+    } else {
+        s.timestampMode.fetch_and(~kModeMonotonic, std::memory_order_relaxed);
+    }
 }
 
+// Дата і час до секунди форматуються лише при зміні секунди (або режиму),
+// дробова частина щоразу дописується вручну.
+size_t Logger::formatTimestamp(char* out) {
+    State& s = state();
+    uint32_t mode = s.timestampMode.load(std::memory_order_acquire);
+    int64_t us;
+    if (mode & kModeMonotonic) {
+        us = microsSinceEpoch(std::chrono::steady_clock::now())
+           + s.monotonicOffsetUs.load(std::memory_order_relaxed);
+    } else {
+        us = microsSinceEpoch(std::chrono::system_clock::now());
+    }
+    int64_t second = us / 1000000;
+    uint32_t micros = static_cast<uint32_t>(us % 1000000);
+
+    thread_local TimestampCache cache;
+    if (second != cache.second || mode != cache.mode) {
+        std::time_t t = static_cast<std::time_t>(second);
+        std::tm tm{};
+#ifdef _WIN32
+        if (mode & kModeUtc) gmtime_s(&tm, &t);
+        else localtime_s(&tm, &t);
+#else
+        if (mode & kModeUtc) gmtime_r(&t, &tm);
+        else localtime_r(&t, &tm);
+#endif
+        cache.len = std::strftime(cache.text, sizeof(cache.text), "%Y-%m-%d %H:%M:%S", &tm);
+        cache.second = second;
+        cache.mode = mode;
+    }
+
+    std::memcpy(out, cache.text, cache.len);
+    size_t len = cache.len;
+    int digits = 0;
+    uint32_t fraction = 0;
+    switch (static_cast<TimestampPrecision>(mode & kPrecisionMask)) {
+        case TimestampPrecision::Milliseconds: digits = 3; fraction = micros / 1000; break;
+        case TimestampPrecision::Microseconds: digits = 6; fraction = micros; break;
+        default: break;
+    }
+    if (digits > 0) {
+        out[len++] = '.';
+        for (int i = digits - 1; i >= 0; i--) {
+            out[len + i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        len += digits;
+    }
+    return len;
+}
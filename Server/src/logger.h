@@ -1,12 +1,13 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <string>
-#include <fstream>
-#include <mutex>
-#include <ctime>
-#include <iomanip>
-#include <sstream>
 
+// Асинхронний логер: виробники форматують рядок у власний буфер потоку і
+// кладуть його в lock-free чергу, фоновий потік пише записи пачками через
+// writev() — раз на flushInterval або коли назбиралося thresholdBytes.
+// ERROR та shutdown() гарантовано доходять до файлу до повернення.
 class Logger {
 public:
     enum class Level {
@@ -14,17 +15,36 @@ public:
         WARNING,
         ERROR
     };
-    
+
+    enum class TimestampPrecision {
+        Seconds,
+        Milliseconds,
+        Microseconds
+    };
+
+    static const size_t kTimestampSize = 32;
+
     static void init(const std::string& logPath = "/tmp/remotecontrol_client.log");
+    // Дописує всі записи в черзі і зупиняє фоновий потік (викликається і з atexit)
+    static void shutdown();
+    static void setBatching(std::chrono::milliseconds flushInterval, size_t thresholdBytes);
+
+    // Формат позначки часу (за замовчуванням — локальний час з мілісекундами)
+    static void setTimestampPrecision(TimestampPrecision precision);
+    static void setUtcTimestamps(bool enabled);
+    // Час рахується від монотонного годинника плюс зсув до системного,
+    // зафіксований при вмиканні: інтервали між записами не стрибають при
+    // корекції системного часу, тож мікросекундні затримки можна порівнювати.
+    static void setMonotonicTimestamps(bool enabled);
+
     static void log(Level level, const std::string& message);
     static void info(const std::string& message);
     static void warning(const std::string& message);
     static void error(const std::string& message);
-    
+
 private:
-    static std::ofstream logFile_;
-    static std::mutex mutex_;
-    static std::string levelToString(Level level);
-    static std::string getTimestamp();
+    static const char* levelToString(Level level);
+    // Пише позначку часу в out (не менше kTimestampSize байтів), повертає довжину
+    static size_t formatTimestamp(char* out);
+    static void writerLoop();
 };
-
@@ -1,13 +1,13 @@
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <cstdlib>
 #include <thread>
 #include <chrono>
 #include <atomic>
-#include <algorithm>
-#include "websocket_server.h"
 #include "keyboard_simulator.h"
 #include "logger.h"
+#include "remote_control_server.h"
 #ifdef _WIN32
 #include "tray_win.h"
 #endif
@@ -15,71 +15,11 @@
 #ifdef _WIN32
 #include <windows.h>
 #else
-#include <signal.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #endif
 
-class RemoteControlServer {
-public:
-#ifdef _WIN32
-    explicit RemoteControlServer(std::atomic<bool>* trayQuit = nullptr) : running_(true), trayQuit_(trayQuit) {
-#else
-    RemoteControlServer() : running_(true), trayQuit_(nullptr) {
-#endif
-#ifndef _WIN32
-        signal(SIGTERM, [](int) {
-            Logger::info("Отримано сигнал завершення. Зупиняємо програму...");
-            exit(0);
-        });
-        signal(SIGINT, [](int) {
-            Logger::info("Отримано сигнал переривання. Зупиняємо програму...");
-            exit(0);
-        });
-#endif
-    }
-
-    void run() {
-        Logger::info("=== Remote Control Server ===");
-        Logger::info("Сервер приймає підключення та виконує команди left/right");
-
-        server_.setMessageCallback([this](const std::string& message) {
-            handleMessage(message);
-        });
-
-        Logger::info("Запуск WebSocket сервера на порту 8765");
-        server_.start();
-
-        while (running_ && server_.isRunning() && (!trayQuit_ || !trayQuit_->load())) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-        running_ = false;
-
-        server_.stop();
-        Logger::info("Програма завершена.");
-    }
-
-private:
-    void handleMessage(const std::string& message) {
-        std::string cleanMessage = message;
-        cleanMessage.erase(std::remove_if(cleanMessage.begin(), cleanMessage.end(),
-            [](char c) { return c < 32 || c > 126; }), cleanMessage.end());
-
-        if (cleanMessage == "right" || cleanMessage == "RIGHT") {
-            KeyboardSimulator::simulateKey("right");
-        } else if (cleanMessage == "left" || cleanMessage == "LEFT") {
-            KeyboardSimulator::simulateKey("left");
-        } else {
-            Logger::warning("Невідома команда: " + cleanMessage);
-        }
-    }
-
-    WebSocketServer server_{8765};
-    std::atomic<bool> running_;
-    std::atomic<bool>* trayQuit_ = nullptr;
-};
-
 #ifndef _WIN32
 static void daemonize() {
     pid_t pid = fork();
@@ -103,6 +43,15 @@ static void daemonize() {
 static std::string defaultLogPath() {
     return "/tmp/remotecontrol_server.log";
 }
+
+// daemonize() робить chdir("/"), тож відносний шлях розв'язуємо до нього
+static std::string absolutePath(const std::string& path) {
+    char* full = realpath(path.c_str(), nullptr);
+    if (!full) return path;
+    std::string result(full);
+    free(full);
+    return result;
+}
 #else
 static std::string defaultLogPath() {
     const char* tmp = getenv("TEMP");
@@ -111,6 +60,11 @@ static std::string defaultLogPath() {
     if (tmp && tmp[0]) return std::string(tmp) + "\\remotecontrol_server.log";
     return "remotecontrol_server.log";
 }
+
+static std::string absolutePath(const std::string& path) {
+    char full[MAX_PATH];
+    return _fullpath(full, path.c_str(), sizeof(full)) ? std::string(full) : path;
+}
 #endif
 
 int main(int argc, char* argv[]) {
@@ -122,10 +76,63 @@ int main(int argc, char* argv[]) {
 #endif
 
     bool runAsDaemon = true;
+    OverflowPolicy queuePolicy = OverflowPolicy::Coalesce;
+    std::string webRoot;
+    bool compression = true;
+    bool ioUring = true;
+    size_t shards = 1;
+    std::chrono::milliseconds tapHold(0);
+    std::chrono::milliseconds pointerTick(8);
+    std::chrono::milliseconds backpressureTimeout(0);
+    bool recordInput = false;
+    std::string tlsCert, tlsKey;
     for (int i = 1; i < argc; i++) {
-        if (std::string(argv[i]) == "--foreground" || std::string(argv[i]) == "-f") {
+        std::string arg = argv[i];
+        if (arg == "--foreground" || arg == "-f") {
             runAsDaemon = false;
-            break;
+        } else if (arg == "--queue-policy=drop-oldest") {
+            queuePolicy = OverflowPolicy::DropOldest;
+        } else if (arg == "--queue-policy=coalesce") {
+            queuePolicy = OverflowPolicy::Coalesce;
+        } else if (arg == "--queue-policy=backpressure") {
+            queuePolicy = OverflowPolicy::Backpressure;
+        } else if (arg.compare(0, 24, "--queue-backpressure-ms=") == 0 && arg.size() > 24) {
+            // Скільки мережевий потік чекає на місце в повній черзі; 0 — не чекати
+            backpressureTimeout = std::chrono::milliseconds(std::strtoul(arg.c_str() + 24, nullptr, 10));
+        } else if (arg == "--log-timestamps=s") {
+            Logger::setTimestampPrecision(Logger::TimestampPrecision::Seconds);
+        } else if (arg == "--log-timestamps=ms") {
+            Logger::setTimestampPrecision(Logger::TimestampPrecision::Milliseconds);
+        } else if (arg == "--log-timestamps=us") {
+            Logger::setTimestampPrecision(Logger::TimestampPrecision::Microseconds);
+        } else if (arg == "--log-timestamps=mono-us") {
+            // Для вимірювання затримок команд: мікросекунди без стрибків системного часу
+            Logger::setTimestampPrecision(Logger::TimestampPrecision::Microseconds);
+            Logger::setMonotonicTimestamps(true);
+        } else if (arg.compare(0, 11, "--web-root=") == 0 && arg.size() > 11) {
+            // Web/index.html віддається на тому ж порту, що й WebSocket
+            webRoot = absolutePath(arg.substr(11));
+        } else if (arg == "--no-deflate") {
+            compression = false;
+        } else if (arg == "--no-io-uring") {
+            ioUring = false;
+        } else if (arg.compare(0, 9, "--shards=") == 0 && arg.size() > 9) {
+            // Кілька потоків на порту 8765 (SO_REUSEPORT); 0 — по одному на ядро
+            shards = static_cast<size_t>(std::strtoul(arg.c_str() + 9, nullptr, 10));
+        } else if (arg.compare(0, 14, "--tap-hold-ms=") == 0 && arg.size() > 14) {
+            // Для програм, що не помічають натискання без паузи між down і up
+            tapHold = std::chrono::milliseconds(std::strtoul(arg.c_str() + 14, nullptr, 10));
+        } else if (arg.compare(0, 18, "--pointer-tick-ms=") == 0 && arg.size() > 18) {
+            // Як часто вводиться накопичений рух вказівника; 0 — щойно потік вільний
+            pointerTick = std::chrono::milliseconds(std::strtoul(arg.c_str() + 18, nullptr, 10));
+        } else if (arg == "--input=recording") {
+            // Навантажувальні тести без дисплея: сервер працює повністю, але
+            // нічого не вводить у систему
+            recordInput = true;
+        } else if (arg.compare(0, 11, "--tls-cert=") == 0 && arg.size() > 11) {
+            tlsCert = absolutePath(arg.substr(11));
+        } else if (arg.compare(0, 10, "--tls-key=") == 0 && arg.size() > 10) {
+            tlsKey = absolutePath(arg.substr(10));
         }
     }
 
@@ -143,6 +150,16 @@ int main(int argc, char* argv[]) {
         std::atomic<bool> trayQuit{false};
         std::thread trayThread([&trayQuit] { tray::run(trayQuit); });
         RemoteControlServer server(&trayQuit);
+        server.setQueuePolicy(queuePolicy);
+        server.setBackpressureTimeout(backpressureTimeout);
+        server.setWebRoot(webRoot);
+        server.setCompression(compression);
+        server.setIoUring(ioUring);
+        server.setShards(shards);
+        server.setTapHold(tapHold);
+        server.setPointerTick(pointerTick);
+        server.setRecordInput(recordInput);
+        server.setTls(tlsCert, tlsKey);
         server.run();
         trayQuit.store(true);
         HWND h = FindWindowW(L"RemoteControlTray", nullptr);
@@ -150,6 +167,16 @@ int main(int argc, char* argv[]) {
         if (trayThread.joinable()) trayThread.join();
 #else
         RemoteControlServer server;
+        server.setQueuePolicy(queuePolicy);
+        server.setBackpressureTimeout(backpressureTimeout);
+        server.setWebRoot(webRoot);
+        server.setCompression(compression);
+        server.setIoUring(ioUring);
+        server.setShards(shards);
+        server.setTapHold(tapHold);
+        server.setPointerTick(pointerTick);
+        server.setRecordInput(recordInput);
+        server.setTls(tlsCert, tlsKey);
         server.run();
 #endif
     } catch (const std::exception& e) {
@@ -0,0 +1,39 @@
+#include "recording_backend.h"
+#include "latency_stats.h"
+
+RecordingBackend::RecordingBackend(size_t capacity) {
+    size_t cap = 2;
+    while (cap < capacity) cap <<= 1;
+    ring_.reset(new Slot[cap]);
+    mask_ = cap - 1;
+}
+
+// Як у seqlock: слот події seq + capacity() пишеться лише після того, як
+// recorded_ досяг seq + capacity(), а бар'єр не дає записам слоту випередити
+// це значення. Читач, що побачив хоч одне нове поле, побачить і його.
+void RecordingBackend::record(RecordedEvent::Type type, int code, int x, int y) {
+    uint64_t seq = recorded_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& slot = ring_[seq & mask_];
+    slot.timeNs.store(latency::now(), std::memory_order_relaxed);
+    slot.type.store(type, std::memory_order_relaxed);
+    slot.code.store(code, std::memory_order_relaxed);
+    slot.x.store(x, std::memory_order_relaxed);
+    slot.y.store(y, std::memory_order_relaxed);
+    recorded_.store(seq + 1, std::memory_order_release);
+}
+
+bool RecordingBackend::event(uint64_t seq, RecordedEvent& out) const {
+    uint64_t written = recorded();
+    // written - seq == capacity(): слот seq уже віддано наступній події
+    if (seq >= written || written - seq >= capacity()) return false;
+    const Slot& slot = ring_[seq & mask_];
+    out.timeNs = slot.timeNs.load(std::memory_order_relaxed);
+    out.type = static_cast<RecordedEvent::Type>(slot.type.load(std::memory_order_relaxed));
+    out.code = slot.code.load(std::memory_order_relaxed);
+    out.x = slot.x.load(std::memory_order_relaxed);
+    out.y = slot.y.load(std::memory_order_relaxed);
+    // Писач міг почати перезапис, поки ми копіювали
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return recorded_.load(std::memory_order_relaxed) - seq < capacity();
+}
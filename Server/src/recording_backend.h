@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "input_backend.h"
+
+// Подія, яку потік ін'єкції передав би системі
+struct RecordedEvent {
+    enum Type : uint8_t {
+        KeyDown,
+        KeyUp,
+        Move,
+        MoveTo,
+        ButtonDown,
+        ButtonUp,
+        Scroll,
+        Flush
+    };
+    uint64_t timeNs; // latency::now()
+    Type type;
+    int32_t code;    // keys::KeyId або MouseButton
+    int32_t x;
+    int32_t y;
+};
+
+// Бекенд без дисплея: кожна подія з міткою часу пишеться в заздалегідь
+// виділене кільце, без алокацій і системних викликів. Для бенчмарків і
+// навантажувальних тестів усього конвеєра сервера без X/Windows/macOS.
+// Пише лише потік ін'єкції; читати можна з будь-якого потоку, поки читач
+// відстає від запису менше ніж на capacity подій. Подію, яку перезаписали
+// до або під час читання, event() не повертає.
+class RecordingBackend : public InputBackend {
+public:
+    explicit RecordingBackend(size_t capacity = 1 << 16);
+
+    const char* name() const override { return "recording"; }
+    bool open() override { return true; }
+    // Код клавіші — сам keys::KeyId
+    int keyCode(keys::KeyId key) override { return key; }
+    void keyDown(int keyCode) override { record(RecordedEvent::KeyDown, keyCode); }
+    void keyUp(int keyCode) override { record(RecordedEvent::KeyUp, keyCode); }
+    void moveBy(int dx, int dy) override { record(RecordedEvent::Move, 0, dx, dy); }
+    void moveTo(int x, int y) override { record(RecordedEvent::MoveTo, 0, x, y); }
+    void button(int button, bool press) override {
+        record(press ? RecordedEvent::ButtonDown : RecordedEvent::ButtonUp, button);
+    }
+    void scroll(int dx, int dy) override { record(RecordedEvent::Scroll, 0, dx, dy); }
+    void flush() override { record(RecordedEvent::Flush, 0); }
+
+    size_t capacity() const { return mask_ + 1; }
+    // Скільки подій записано від створення; номер наступної
+    uint64_t recorded() const { return recorded_.load(std::memory_order_acquire); }
+    // Подія з номером seq (0..recorded()-1); false, якщо її вже перезаписано
+    bool event(uint64_t seq, RecordedEvent& out) const;
+
+private:
+    // Поля атомарні (relaxed): читач може копіювати слот, який саме
+    // перезаписується, і це не гонка даних — таку копію event() відкидає
+    struct Slot {
+        std::atomic<uint64_t> timeNs{0};
+        std::atomic<uint8_t> type{0};
+        std::atomic<int32_t> code{0};
+        std::atomic<int32_t> x{0};
+        std::atomic<int32_t> y{0};
+    };
+
+    void record(RecordedEvent::Type type, int code, int x = 0, int y = 0);
+
+    std::unique_ptr<Slot[]> ring_;
+    size_t mask_ = 0;
+    std::atomic<uint64_t> recorded_{0};
+};
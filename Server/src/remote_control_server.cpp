@@ -0,0 +1,310 @@
+#include "remote_control_server.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include "key_table.h"
+#include "latency_stats.h"
+#include "logger.h"
+#include "recording_backend.h"
+
+#ifndef _WIN32
+#include <signal.h>
+
+// Другий сигнал (подвійний Ctrl+C, timeout шле його і процесу, і групі)
+// приходить в інший потік, поки exit() ще руйнує статичні об'єкти
+static void exitOnSignal(const char* message) {
+    static std::atomic<bool> exiting{false};
+    if (exiting.exchange(true)) return;
+    Logger::info(message);
+    exit(0);
+}
+#endif
+
+RemoteControlServer::RemoteControlServer(std::atomic<bool>* trayQuit) : running_(true), trayQuit_(trayQuit) {}
+
+void RemoteControlServer::run() {
+#ifndef _WIN32
+    signal(SIGTERM, [](int) { exitOnSignal("Отримано сигнал завершення. Зупиняємо програму..."); });
+    signal(SIGINT, [](int) { exitOnSignal("Отримано сигнал переривання. Зупиняємо програму..."); });
+#endif
+    Logger::info("=== Remote Control Server ===");
+    Logger::info("Сервер приймає підключення та виконує команди left/right");
+
+    start();
+
+    auto nextStatsDump = std::chrono::steady_clock::now() + kStatsDumpInterval;
+    uint64_t dumpedCount = 0;
+    while (running_ && shardsRunning() && (!trayQuit_ || !trayQuit_->load())) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (std::chrono::steady_clock::now() >= nextStatsDump) {
+            nextStatsDump += kStatsDumpInterval;
+            uint64_t count = latency::histogram(latency::StageTotal).count();
+            if (count != dumpedCount) {
+                dumpedCount = count;
+                Logger::info("Затримки команд: " + latency::summary());
+            }
+        }
+    }
+
+    stop();
+    Logger::info("Програма завершена.");
+}
+
+void RemoteControlServer::start() {
+    size_t shardCount = shardCount_;
+    unsigned cpus = std::thread::hardware_concurrency();
+    if (shardCount == 0) shardCount = cpus ? cpus : 1;
+#ifndef __linux__
+    // Поза Linux SO_REUSEPORT не розподіляє з'єднання між сокетами
+    if (shardCount > 1) {
+        Logger::warning("Шарди підтримуються лише на Linux, працюємо з одним");
+        shardCount = 1;
+    }
+#endif
+
+    std::unique_ptr<InputBackend> input;
+    if (recordInput_) input.reset(new RecordingBackend());
+    else input = createPlatformInputBackend();
+    Logger::info(std::string("Бекенд вводу: ") + input->name());
+    KeyboardSimulator::setBackend(std::move(input));
+    KeyboardSimulator::setTapHold(tapHold_);
+    KeyboardSimulator::setPointerTick(pointerTick_);
+    KeyboardSimulator::setBackpressureTimeout(backpressureTimeout_);
+    if (!KeyboardSimulator::start(KeyboardSimulator::kDefaultQueueCapacity, queuePolicy_, shardCount)) {
+        Logger::error("Не вдалося запустити симуляцію клавіатури");
+    }
+
+    for (size_t i = 0; i < shardCount; i++) {
+        shards_.emplace_back(new Shard(i, port_));
+        Shard& shard = *shards_.back();
+        WebSocketServer& server = shard.server;
+        server.setMessageCallback([this, &shard](const std::string& message) {
+            handleMessage(shard, message);
+        });
+        server.setBinaryCallback([this, &shard](const uint8_t* data, size_t size) {
+            handleBinary(shard, data, size);
+        });
+        server.setCloseCallback([this, &shard](WebSocketServer::ConnectionId id) {
+            releaseHeld(shard, id);
+        });
+        if (shardCount > 1) {
+            server.setReusePort(true);
+            server.setCpu(cpus ? static_cast<int>(i % cpus) : -1);
+        }
+
+        if (!webRoot_.empty()) server.setWebRoot(webRoot_);
+        // Ключ може лежати в тому ж PEM, що й сертифікат
+        if (!tlsCert_.empty()) {
+            if (!server.setTls(tlsCert_, tlsKey_.empty() ? tlsCert_ : tlsKey_))
+                throw std::runtime_error("не вдалося налаштувати TLS");
+            // Телефон, що перепідключився, потрапить на довільний шард
+            if (i > 0 && !server.shareTlsTickets(shards_[0]->server))
+                Logger::warning("Квитки TLS не спільні: відновлення сесії лише на тому ж шарді");
+        }
+        server.setCompression(compression_);
+        server.setIoUring(ioUring_);
+    }
+
+    Logger::info("Запуск WebSocket сервера на порту " + std::to_string(port_)
+                 + ", шардів: " + std::to_string(shardCount));
+    for (auto& shard : shards_) shard->server.start();
+}
+
+void RemoteControlServer::stop() {
+    running_ = false;
+
+    for (auto& shard : shards_) shard->server.stop();
+    KeyboardSimulator::stop();
+    shards_.clear();
+
+    Logger::info("Затримки команд: " + latency::summary());
+    QueueStats qs = KeyboardSimulator::queueStats();
+    Logger::info("Черга команд: прийнято " + std::to_string(qs.enqueued)
+                 + ", злито " + std::to_string(qs.coalesced)
+                 + ", відкинуто " + std::to_string(qs.dropped)
+                 + ", макс. глибина " + std::to_string(qs.highWater));
+}
+
+// Якщо один шард не зміг стартувати (порт зайнятий), зупиняємо всі
+bool RemoteControlServer::shardsRunning() const {
+    for (const auto& shard : shards_) {
+        if (!shard->server.isRunning()) return false;
+    }
+    return !shards_.empty();
+}
+
+// Текстовий протокол: назва клавіші ("left", "RIGHT", "f5", "space"...)
+// або службова команда "stats"
+void RemoteControlServer::handleMessage(Shard& shard, const std::string& message) {
+    latency::current().dispatched = latency::now();
+    std::string_view cmd(message);
+    while (!cmd.empty() && (cmd.front() < 33 || cmd.front() > 126)) cmd.remove_prefix(1);
+    while (!cmd.empty() && (cmd.back() < 33 || cmd.back() > 126)) cmd.remove_suffix(1);
+
+    if (cmd == "stats") {
+        std::string stats = latency::summary();
+        Logger::info("Затримки команд: " + stats);
+        shard.server.sendText(shard.server.messageConnection(), stats);
+        return;
+    }
+
+    keys::KeyId key = keys::find(cmd);
+    if (key == keys::kInvalidKey) {
+        Logger::warning("Невідома команда: " + std::string(cmd));
+        return;
+    }
+    KeyCommand kc;
+    kc.key = key;
+    kc.repeat = 1;
+    kc.modifiers = 0;
+    kc.timing = latency::current();
+    KeyboardSimulator::enqueue(kc, shard.index);
+}
+
+const RemoteControlServer::DispatchTable& RemoteControlServer::dispatchTable() {
+    static const DispatchTable table = [] {
+        DispatchTable t = {};
+        t.handlers[proto::OpKeyTap] = &RemoteControlServer::onKeyTap;
+        t.handlers[proto::OpKeyDown] = &RemoteControlServer::onKeyDown;
+        t.handlers[proto::OpKeyUp] = &RemoteControlServer::onKeyUp;
+        t.handlers[proto::OpPointerMove] = &RemoteControlServer::onPointerMove;
+        t.handlers[proto::OpPointerMoveTo] = &RemoteControlServer::onPointerMoveTo;
+        t.handlers[proto::OpButtonDown] = &RemoteControlServer::onButtonDown;
+        t.handlers[proto::OpButtonUp] = &RemoteControlServer::onButtonUp;
+        t.handlers[proto::OpScroll] = &RemoteControlServer::onScroll;
+        return t;
+    }();
+    return table;
+}
+
+void RemoteControlServer::handleBinary(Shard& shard, const uint8_t* data, size_t size) {
+    latency::current().dispatched = latency::now();
+    if (size % proto::kRecordSize != 0) {
+        Logger::warning("Некоректна довжина бінарної команди: " + std::to_string(size));
+        return;
+    }
+    const DispatchTable& table = dispatchTable();
+    for (size_t off = 0; off < size; off += proto::kRecordSize) {
+        proto::Command cmd = proto::decode(data + off);
+        BinaryHandler handler = table.handlers[cmd.op];
+        if (handler) {
+            (this->*handler)(shard, cmd);
+        } else {
+            Logger::warning("Невідомий бінарний opcode: " + std::to_string(cmd.op));
+        }
+    }
+}
+
+void RemoteControlServer::onKeyTap(Shard& shard, const proto::Command& cmd) {
+    if (cmd.key >= keys::kKeyCount) {
+        Logger::warning("Невідомий код клавіші: " + std::to_string(cmd.key));
+        return;
+    }
+    KeyCommand key;
+    key.key = cmd.key;
+    key.repeat = cmd.repeat;
+    key.modifiers = cmd.modifiers;
+    key.timing = latency::current();
+    KeyboardSimulator::enqueue(key, shard.index);
+}
+
+// Повторний OpKeyDown (автоповтор клавіатури клієнта) і OpKeyUp без
+// OpKeyDown ігноруються: з'єднання утримує кожну клавішу не більше разу
+void RemoteControlServer::onKeyDown(Shard& shard, const proto::Command& cmd) {
+    if (cmd.key >= keys::kKeyCount) {
+        Logger::warning("Невідомий код клавіші: " + std::to_string(cmd.key));
+        return;
+    }
+    // Утримання запам'ятовуємо, лише коли натискання потрапило в чергу:
+    // інакше відпускати не буде чого
+    std::vector<uint16_t>& held = shard.held[shard.server.messageConnection()].keys;
+    if (std::find(held.begin(), held.end(), cmd.key) != held.end()) return;
+    if (enqueueHold(shard, cmd.key, KeyAction::Press)) held.push_back(cmd.key);
+}
+
+void RemoteControlServer::onKeyUp(Shard& shard, const proto::Command& cmd) {
+    auto it = shard.held.find(shard.server.messageConnection());
+    if (it == shard.held.end()) return;
+    std::vector<uint16_t>& held = it->second.keys;
+    auto key = std::find(held.begin(), held.end(), cmd.key);
+    if (key == held.end()) return;
+    held.erase(key);
+    if (held.empty() && it->second.buttons == 0) shard.held.erase(it);
+    enqueueHold(shard, cmd.key, KeyAction::Release);
+}
+
+void RemoteControlServer::onPointerMove(Shard& shard, const proto::Command& cmd) {
+    enqueuePointer(shard, KeyAction::PointerMove, proto::toSigned(cmd.key), proto::toSigned(cmd.repeat));
+}
+
+void RemoteControlServer::onPointerMoveTo(Shard& shard, const proto::Command& cmd) {
+    enqueuePointer(shard, KeyAction::PointerMoveTo, cmd.key, cmd.repeat);
+}
+
+void RemoteControlServer::onScroll(Shard& shard, const proto::Command& cmd) {
+    enqueuePointer(shard, KeyAction::Scroll, proto::toSigned(cmd.key), proto::toSigned(cmd.repeat));
+}
+
+// Кнопки утримуються так само, як клавіші з OpKeyDown
+void RemoteControlServer::onButtonDown(Shard& shard, const proto::Command& cmd) {
+    if (cmd.key == 0 || cmd.key >= kButtonCount) {
+        Logger::warning("Невідома кнопка миші: " + std::to_string(cmd.key));
+        return;
+    }
+    uint8_t& buttons = shard.held[shard.server.messageConnection()].buttons;
+    if (buttons & (1u << cmd.key)) return;
+    if (enqueueHold(shard, cmd.key, KeyAction::ButtonDown)) buttons |= static_cast<uint8_t>(1u << cmd.key);
+}
+
+void RemoteControlServer::onButtonUp(Shard& shard, const proto::Command& cmd) {
+    if (cmd.key == 0 || cmd.key >= kButtonCount) return;
+    auto it = shard.held.find(shard.server.messageConnection());
+    if (it == shard.held.end() || !(it->second.buttons & (1u << cmd.key))) return;
+    it->second.buttons &= static_cast<uint8_t>(~(1u << cmd.key));
+    if (it->second.keys.empty() && it->second.buttons == 0) shard.held.erase(it);
+    enqueueHold(shard, cmd.key, KeyAction::ButtonUp);
+}
+
+// З'єднання зникло, не відпустивши клавіш (закрилося, обірвалося, тайм-аут)
+void RemoteControlServer::releaseHeld(Shard& shard, WebSocketServer::ConnectionId id) {
+    auto it = shard.held.find(id);
+    if (it == shard.held.end()) return;
+    const Held& held = it->second;
+    Logger::info("Відпускаємо клавіші закритого з'єднання: " + std::to_string(held.keys.size()));
+    for (uint16_t key : held.keys) enqueueHold(shard, key, KeyAction::Release);
+    for (uint16_t button = 1; button < kButtonCount; button++) {
+        if (held.buttons & (1u << button)) enqueueHold(shard, button, KeyAction::ButtonUp);
+    }
+    shard.held.erase(it);
+}
+
+// Відпускання KeyboardSimulator не відкидає, тож false для них означає, що
+// ін'єкція вже не працює
+bool RemoteControlServer::enqueueHold(Shard& shard, uint16_t key, KeyAction action) {
+    KeyCommand kc;
+    kc.key = key;
+    kc.repeat = 1;
+    kc.modifiers = 0;
+    kc.action = action;
+    bool press = action == KeyAction::Press || action == KeyAction::ButtonDown;
+    kc.timing = press ? latency::current() : latency::Timing();
+    if (KeyboardSimulator::enqueue(kc, shard.index)) return true;
+    Logger::warning(std::string(press ? "Натискання" : "Відпускання") + " не поставлено в чергу: "
+                    + (action == KeyAction::Press || action == KeyAction::Release ? "клавіша " : "кнопка ")
+                    + std::to_string(key));
+    return false;
+}
+
+void RemoteControlServer::enqueuePointer(Shard& shard, KeyAction action, int32_t x, int32_t y) {
+    KeyCommand kc;
+    kc.key = 0;
+    kc.repeat = 1;
+    kc.modifiers = 0;
+    kc.action = action;
+    kc.x = x;
+    kc.y = y;
+    KeyboardSimulator::enqueue(kc, shard.index);
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "command_protocol.h"
+#include "keyboard_simulator.h"
+#include "websocket_server.h"
+
+// Сервер керування: шарди WebSocketServer на спільному порту, розбір команд
+// клієнта і передача їх у KeyboardSimulator.
+class RemoteControlServer {
+public:
+    // trayQuit — прапорець виходу з трею (Windows)
+    explicit RemoteControlServer(std::atomic<bool>* trayQuit = nullptr);
+
+    // Працює до сигналу завершення, виходу з трею або падіння шарду
+    void run();
+    // Частини run(): запуск ін'єкції й шардів і зупинка з підсумковою статистикою
+    void start();
+    void stop();
+
+    void setPort(uint16_t port) { port_ = port; }
+    void setQueuePolicy(OverflowPolicy policy) { queuePolicy_ = policy; }
+    // Найдовше очікування мережевого потоку на місце в повній черзі команд
+    void setBackpressureTimeout(std::chrono::milliseconds timeout) { backpressureTimeout_ = timeout; }
+    void setWebRoot(const std::string& dir) { webRoot_ = dir; }
+    void setCompression(bool enabled) { compression_ = enabled; }
+    void setIoUring(bool enabled) { ioUring_ = enabled; }
+    // 0 — по шарду на кожне ядро
+    void setShards(size_t count) { shardCount_ = count; }
+    void setTapHold(std::chrono::milliseconds hold) { tapHold_ = hold; }
+    void setPointerTick(std::chrono::milliseconds tick) { pointerTick_ = tick; }
+    // Події вводу лише пишуться в пам'ять (RecordingBackend), без дисплея
+    void setRecordInput(bool enabled) { recordInput_ = enabled; }
+    void setTls(const std::string& certFile, const std::string& keyFile) {
+        tlsCert_ = certFile;
+        tlsKey_ = keyFile;
+    }
+
+private:
+    // Розбір команд без мережі для bench/remotecontrol_bench.cpp
+    friend class DispatchBench;
+
+    static constexpr std::chrono::seconds kStatsDumpInterval{60};
+
+    struct Held {
+        std::vector<uint16_t> keys;
+        uint8_t buttons = 0; // біт на MouseButton
+    };
+
+    // Незалежний сервер на спільному порту зі своїм потоком; index — номер
+    // його черги команд у KeyboardSimulator
+    struct Shard {
+        Shard(size_t i, uint16_t port) : index(i), server(port) {}
+        size_t index;
+        WebSocketServer server;
+        // Що утримують з'єднання шарду (OpKeyDown, OpButtonDown); лише потік шарду
+        std::unordered_map<WebSocketServer::ConnectionId, Held> held;
+    };
+
+    using BinaryHandler = void (RemoteControlServer::*)(Shard&, const proto::Command&);
+
+    struct DispatchTable {
+        BinaryHandler handlers[256];
+    };
+
+    static const DispatchTable& dispatchTable();
+
+    bool shardsRunning() const;
+    void handleMessage(Shard& shard, const std::string& message);
+    void handleBinary(Shard& shard, const uint8_t* data, size_t size);
+    void onKeyTap(Shard& shard, const proto::Command& cmd);
+    void onKeyDown(Shard& shard, const proto::Command& cmd);
+    void onKeyUp(Shard& shard, const proto::Command& cmd);
+    void onPointerMove(Shard& shard, const proto::Command& cmd);
+    void onPointerMoveTo(Shard& shard, const proto::Command& cmd);
+    void onScroll(Shard& shard, const proto::Command& cmd);
+    void onButtonDown(Shard& shard, const proto::Command& cmd);
+    void onButtonUp(Shard& shard, const proto::Command& cmd);
+    void releaseHeld(Shard& shard, WebSocketServer::ConnectionId id);
+    bool enqueueHold(Shard& shard, uint16_t key, KeyAction action);
+    void enqueuePointer(Shard& shard, KeyAction action, int32_t x, int32_t y);
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    uint16_t port_ = 8765;
+    size_t shardCount_ = 1;
+    std::chrono::milliseconds tapHold_{0};
+    std::chrono::milliseconds pointerTick_{8};
+    bool recordInput_ = false;
+    OverflowPolicy queuePolicy_ = OverflowPolicy::Coalesce;
+    std::chrono::milliseconds backpressureTimeout_{0};
+    std::string webRoot_;
+    bool compression_ = true;
+    bool ioUring_ = true;
+    std::string tlsCert_;
+    std::string tlsKey_;
+    std::atomic<bool> running_;
+    std::atomic<bool>* trayQuit_ = nullptr;
+};
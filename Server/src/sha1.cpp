@@ -1,43 +1,79 @@
 #include "sha1.h"
 #include <cstring>
-#include <cstdint>
+
+#if defined(SHA1_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+#if defined(SHA1_ARMV8)
+#include <arm_neon.h>
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+#if defined(__clang__)
+#define SHA1_TARGET_X86 __attribute__((target("sha,sse4.1,ssse3")))
+#define SHA1_TARGET_ARM __attribute__((target("sha2")))
+#elif defined(__GNUC__)
+#define SHA1_TARGET_X86 __attribute__((target("sha,sse4.1,ssse3")))
+#define SHA1_TARGET_ARM __attribute__((target("+crypto")))
+#else
+#define SHA1_TARGET_X86
+#define SHA1_TARGET_ARM
+#endif
 
 namespace sha1 {
 
 namespace {
-    // SHA1 константи
-    const uint32_t h0 = 0x67452301;
-    const uint32_t h1 = 0xEFCDAB89;
-    const uint32_t h2 = 0x98BADCFE;
-    const uint32_t h3 = 0x10325476;
-    const uint32_t h4 = 0xC3D2E1F0;
-
-    inline uint32_t leftRotate(uint32_t value, uint32_t amount) {
-        return (value << amount) | (value >> (32 - amount));
-    }
 
-    void processChunk(const uint8_t* chunk, uint32_t* h) {
-        uint32_t w[80];
-        
-        // Копіюємо chunk у перші 16 слів
-        for (int i = 0; i < 16; i++) {
-            w[i] = (chunk[i * 4] << 24) | (chunk[i * 4 + 1] << 16) |
-                   (chunk[i * 4 + 2] << 8) | chunk[i * 4 + 3];
-        }
-        
-        // Розширюємо до 80 слів
-        for (int i = 16; i < 80; i++) {
-            w[i] = leftRotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
-        }
-        
-        uint32_t a = h[0];
-        uint32_t b = h[1];
-        uint32_t c = h[2];
-        uint32_t d = h[3];
-        uint32_t e = h[4];
-        
-        // Основний цикл SHA1
+// SHA1 константи
+const uint32_t kInit[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+inline uint32_t leftRotate(uint32_t value, uint32_t amount) {
+    return (value << amount) | (value >> (32 - amount));
+}
+
+inline uint32_t loadBE32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16)
+         | (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+inline void storeBE32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+} // namespace
+
+namespace detail {
+
+// Розклад повідомлення тримається в кільці з 16 слів замість масиву з 80
+void blocksScalar(uint32_t state[5], const uint8_t* data, size_t blocks) {
+    for (; blocks > 0; blocks--, data += kBlockSize) {
+        uint32_t w[16];
+        for (int i = 0; i < 16; i++)
+            w[i] = loadBE32(data + i * 4);
+
+        uint32_t a = state[0];
+        uint32_t b = state[1];
+        uint32_t c = state[2];
+        uint32_t d = state[3];
+        uint32_t e = state[4];
+
         for (int i = 0; i < 80; i++) {
+            if (i >= 16) {
+                w[i & 15] = leftRotate(w[(i - 3) & 15] ^ w[(i - 8) & 15] ^ w[(i - 14) & 15] ^ w[i & 15], 1);
+            }
             uint32_t f, k;
             if (i < 20) {
                 f = (b & c) | ((~b) & d);
@@ -52,66 +88,254 @@ namespace {
                 f = b ^ c ^ d;
                 k = 0xCA62C1D6;
             }
-            
-            uint32_t temp = leftRotate(a, 5) + f + e + k + w[i];
+            uint32_t temp = leftRotate(a, 5) + f + e + k + w[i & 15];
             e = d;
             d = c;
             c = leftRotate(b, 30);
             b = a;
             a = temp;
         }
-        
-        h[0] += a;
-        h[1] += b;
-        h[2] += c;
-        h[3] += d;
-        h[4] += e;
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+}
+
+#if defined(SHA1_X86)
+
+// Чотири раунди SHA-NI разом з розкладом повідомлення на наступні групи:
+// ea — E поточної групи, m0 — її слова, m1..m3 — слова наступних груп
+#define SHA1_NI_ROUNDS4(ea, eb, m0, m1, m2, m3, func) \
+    ea = _mm_sha1nexte_epu32(ea, m0);                 \
+    eb = abcd;                                        \
+    m1 = _mm_sha1msg2_epu32(m1, m0);                  \
+    abcd = _mm_sha1rnds4_epu32(abcd, ea, func);       \
+    m3 = _mm_sha1msg1_epu32(m3, m0);                  \
+    m2 = _mm_xor_si128(m2, m0)
+
+SHA1_TARGET_X86
+void blocksShaNi(uint32_t state[5], const uint8_t* data, size_t blocks) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+    __m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+    __m128i e1;
+
+    for (; blocks > 0; blocks--, data += kBlockSize) {
+        const __m128i abcdSaved = abcd;
+        const __m128i eSaved = e0;
+        const __m128i* p = reinterpret_cast<const __m128i*>(data);
+
+        // Раунди 0-11: слова завантажуються по одному
+        __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128(p), byteSwap);
+        e0 = _mm_add_epi32(e0, m0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128(p + 1), byteSwap);
+        e1 = _mm_sha1nexte_epu32(e1, m1);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+        m0 = _mm_sha1msg1_epu32(m0, m1);
+
+        __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128(p + 2), byteSwap);
+        e0 = _mm_sha1nexte_epu32(e0, m2);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+        m1 = _mm_sha1msg1_epu32(m1, m2);
+        m0 = _mm_xor_si128(m0, m2);
+
+        __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128(p + 3), byteSwap);
+
+        // Раунди 12-79. Останні групи рахують зайві слова розкладу — вони не використовуються
+        SHA1_NI_ROUNDS4(e1, e0, m3, m0, m1, m2, 0);
+        SHA1_NI_ROUNDS4(e0, e1, m0, m1, m2, m3, 0);
+        SHA1_NI_ROUNDS4(e1, e0, m1, m2, m3, m0, 1);
+        SHA1_NI_ROUNDS4(e0, e1, m2, m3, m0, m1, 1);
+        SHA1_NI_ROUNDS4(e1, e0, m3, m0, m1, m2, 1);
+        SHA1_NI_ROUNDS4(e0, e1, m0, m1, m2, m3, 1);
+        SHA1_NI_ROUNDS4(e1, e0, m1, m2, m3, m0, 1);
+        SHA1_NI_ROUNDS4(e0, e1, m2, m3, m0, m1, 2);
+        SHA1_NI_ROUNDS4(e1, e0, m3, m0, m1, m2, 2);
+        SHA1_NI_ROUNDS4(e0, e1, m0, m1, m2, m3, 2);
+        SHA1_NI_ROUNDS4(e1, e0, m1, m2, m3, m0, 2);
+        SHA1_NI_ROUNDS4(e0, e1, m2, m3, m0, m1, 2);
+        SHA1_NI_ROUNDS4(e1, e0, m3, m0, m1, m2, 3);
+        SHA1_NI_ROUNDS4(e0, e1, m0, m1, m2, m3, 3);
+        SHA1_NI_ROUNDS4(e1, e0, m1, m2, m3, m0, 3);
+        SHA1_NI_ROUNDS4(e0, e1, m2, m3, m0, m1, 3);
+        SHA1_NI_ROUNDS4(e1, e0, m3, m0, m1, m2, 3);
+
+        e0 = _mm_sha1nexte_epu32(e0, eSaved);
+        abcd = _mm_add_epi32(abcd, abcdSaved);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+}
+
+#undef SHA1_NI_ROUNDS4
+
+bool cpuHasShaNi() {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuid(regs, 1);
+    bool ssse3 = (regs[2] & (1 << 9)) != 0;
+    bool sse41 = (regs[2] & (1 << 19)) != 0;
+    __cpuidex(regs, 7, 0);
+    return ssse3 && sse41 && (regs[1] & (1 << 29)) != 0;
+#else
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_max(0, nullptr) < 7 || !__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    bool ssse3 = (ecx & bit_SSSE3) != 0;
+    bool sse41 = (ecx & bit_SSE4_1) != 0;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+    return ssse3 && sse41 && (ebx & (1u << 29)) != 0;
+#endif
+}
+
+#endif
+
+#if defined(SHA1_ARMV8)
+
+SHA1_TARGET_ARM
+void blocksArmv8(uint32_t state[5], const uint8_t* data, size_t blocks) {
+    const uint32x4_t k[4] = {vdupq_n_u32(0x5A827999), vdupq_n_u32(0x6ED9EBA1),
+                             vdupq_n_u32(0x8F1BBCDC), vdupq_n_u32(0xCA62C1D6)};
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32_t e = state[4];
+
+    for (; blocks > 0; blocks--, data += kBlockSize) {
+        const uint32x4_t abcdSaved = abcd;
+        const uint32_t eSaved = e;
+        uint32x4_t w[4];
+        for (int i = 0; i < 4; i++)
+            w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 16)));
+
+        // 20 груп по 4 раунди; w[g & 3] після використання замінюється словами групи g + 4
+        for (int g = 0; g < 20; g++) {
+            uint32x4_t wk = vaddq_u32(w[g & 3], k[g / 5]);
+            uint32_t eNext = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+            if (g < 5) abcd = vsha1cq_u32(abcd, e, wk);
+            else if (g < 10 || g >= 15) abcd = vsha1pq_u32(abcd, e, wk);
+            else abcd = vsha1mq_u32(abcd, e, wk);
+            e = eNext;
+            if (g < 16) {
+                w[g & 3] = vsha1su1q_u32(vsha1su0q_u32(w[g & 3], w[(g + 1) & 3], w[(g + 2) & 3]),
+                                         w[(g + 3) & 3]);
+            }
+        }
+
+        abcd = vaddq_u32(abcd, abcdSaved);
+        e += eSaved;
     }
+
+    vst1q_u32(state, abcd);
+    state[4] = e;
+}
+
+bool cpuHasArmv8Sha1() {
+#if defined(_WIN32)
+    return IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE) != 0;
+#elif defined(__linux__) && defined(HWCAP_SHA1)
+    return (getauxval(AT_HWCAP) & HWCAP_SHA1) != 0;
+#elif defined(__APPLE__)
+    return true; // усі Apple Silicon мають Crypto Extensions
+#else
+    return false;
+#endif
+}
+
+#endif
+
+} // namespace detail
+
+namespace {
+
+struct Backend {
+    detail::BlocksFn fn;
+    const char* name;
+};
+
+Backend selectBackend() {
+#if defined(SHA1_X86)
+    if (detail::cpuHasShaNi()) return {detail::blocksShaNi, "sha-ni"};
+#elif defined(SHA1_ARMV8)
+    if (detail::cpuHasArmv8Sha1()) return {detail::blocksArmv8, "armv8-crypto"};
+#endif
+    return {detail::blocksScalar, "scalar"};
+}
+
+const Backend& backend() {
+    static const Backend b = selectBackend();
+    return b;
 }
 
-std::string hash(const unsigned char* data, size_t len) {
-    uint32_t h[5] = {h0, h1, h2, h3, h4};
-    
-    // Обчислюємо кількість повних блоків
-    size_t originalLen = len;
-    size_t totalLen = len + 9; // +1 байт для 0x80, +8 байт для довжини
-    size_t paddedLen = ((totalLen + 63) / 64) * 64;
-    
-    // Створюємо буфер з padding
-    uint8_t* padded = new uint8_t[paddedLen];
-    std::memset(padded, 0, paddedLen);
-    std::memcpy(padded, data, len);
-    padded[len] = 0x80;
-    
-    // Додаємо довжину в бітах як 64-бітне число (big-endian)
-    uint64_t bitLen = originalLen * 8;
-    padded[paddedLen - 8] = (bitLen >> 56) & 0xFF;
-    padded[paddedLen - 7] = (bitLen >> 48) & 0xFF;
-    padded[paddedLen - 6] = (bitLen >> 40) & 0xFF;
-    padded[paddedLen - 5] = (bitLen >> 32) & 0xFF;
-    padded[paddedLen - 4] = (bitLen >> 24) & 0xFF;
-    padded[paddedLen - 3] = (bitLen >> 16) & 0xFF;
-    padded[paddedLen - 2] = (bitLen >> 8) & 0xFF;
-    padded[paddedLen - 1] = bitLen & 0xFF;
-    
-    // Обробляємо кожен 512-бітний блок
-    for (size_t i = 0; i < paddedLen; i += 64) {
-        processChunk(padded + i, h);
+} // namespace
+
+void Context::init() {
+    std::memcpy(state_, kInit, sizeof(state_));
+    length_ = 0;
+    blockLen_ = 0;
+}
+
+void Context::update(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    length_ += len;
+    if (blockLen_ > 0) {
+        size_t take = kBlockSize - blockLen_;
+        if (take > len) take = len;
+        std::memcpy(block_ + blockLen_, p, take);
+        blockLen_ += take;
+        p += take;
+        len -= take;
+        if (blockLen_ < kBlockSize) return;
+        backend().fn(state_, block_, 1);
+        blockLen_ = 0;
+    }
+    // Повні блоки обробляються прямо з вхідних даних, без копіювання
+    size_t blocks = len / kBlockSize;
+    if (blocks > 0) {
+        backend().fn(state_, p, blocks);
+        p += blocks * kBlockSize;
+        len -= blocks * kBlockSize;
     }
-    
-    delete[] padded;
-    
-    // Конвертуємо результат у бінарний рядок (20 байт)
-    std::string result;
-    result.reserve(20);
-    for (int i = 0; i < 5; i++) {
-        result += static_cast<char>((h[i] >> 24) & 0xFF);
-        result += static_cast<char>((h[i] >> 16) & 0xFF);
-        result += static_cast<char>((h[i] >> 8) & 0xFF);
-        result += static_cast<char>(h[i] & 0xFF);
+    if (len > 0) {
+        std::memcpy(block_, p, len);
+        blockLen_ = len;
     }
-    
-    return result;
+}
+
+void Context::final(uint8_t out[kDigestSize]) {
+    uint64_t bitLen = length_ * 8;
+    block_[blockLen_++] = 0x80;
+    if (blockLen_ > kBlockSize - 8) {
+        std::memset(block_ + blockLen_, 0, kBlockSize - blockLen_);
+        backend().fn(state_, block_, 1);
+        blockLen_ = 0;
+    }
+    std::memset(block_ + blockLen_, 0, kBlockSize - 8 - blockLen_);
+    storeBE32(block_ + kBlockSize - 8, static_cast<uint32_t>(bitLen >> 32));
+    storeBE32(block_ + kBlockSize - 4, static_cast<uint32_t>(bitLen));
+    backend().fn(state_, block_, 1);
+    blockLen_ = 0;
+
+    for (int i = 0; i < 5; i++)
+        storeBE32(out + i * 4, state_[i]);
+}
+
+void hash(const void* data, size_t len, uint8_t out[kDigestSize]) {
+    Context ctx;
+    ctx.update(data, len);
+    ctx.final(out);
+}
+
+const char* backendName() {
+    return backend().name;
 }
 
 } // namespace sha1
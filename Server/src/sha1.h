@@ -1,12 +1,54 @@
 #pragma once
 
 #include <cstddef>
-#include <string>
+#include <cstdint>
 
 namespace sha1 {
-// Повертає 20 байт (binary) SHA1 хеш у рядку.
-std::string hash(const unsigned char* data, size_t len);
-inline std::string hash(const std::string& s) {
-    return hash(reinterpret_cast<const unsigned char*>(s.data()), s.size());
-}
-}
+
+const size_t kDigestSize = 20;
+const size_t kBlockSize = 64;
+
+// Потокове обчислення SHA1 без виділень пам'яті:
+// init() -> update()... -> final(). Обробка блоків (скалярна, SHA-NI
+// або ARMv8 Crypto Extensions) обирається один раз під час виконання.
+class Context {
+public:
+    Context() { init(); }
+
+    void init();
+    void update(const void* data, size_t len);
+    // Пише 20 байтів хешу в out; після цього контекст треба знову init()
+    void final(uint8_t out[kDigestSize]);
+
+private:
+    uint32_t state_[5];
+    uint64_t length_;         // оброблено байтів усього
+    uint8_t block_[kBlockSize];
+    size_t blockLen_;         // байтів у неповному блоці
+};
+
+void hash(const void* data, size_t len, uint8_t out[kDigestSize]);
+
+const char* backendName();
+
+// Обробка цілих 64-байтних блоків, яку Context обирає за CPU: скалярна,
+// SHA-NI або ARMv8 Crypto. Відкрито для sha1_bench, щоб порівнювати
+// варіанти між собою, а не лише той, що обрано автоматично.
+namespace detail {
+
+using BlocksFn = void (*)(uint32_t state[5], const uint8_t* data, size_t blocks);
+
+void blocksScalar(uint32_t state[5], const uint8_t* data, size_t blocks);
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SHA1_X86 1
+void blocksShaNi(uint32_t state[5], const uint8_t* data, size_t blocks);
+bool cpuHasShaNi();
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define SHA1_ARMV8 1
+void blocksArmv8(uint32_t state[5], const uint8_t* data, size_t blocks);
+bool cpuHasArmv8Sha1();
+#endif
+
+} // namespace detail
+} // namespace sha1
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+// Поведінка при переповненні черги
+enum class OverflowPolicy {
+    DropOldest,   // викидаємо найстаріший елемент, новий завжди потрапляє в чергу
+    Coalesce,     // зливаємо новий елемент з останнім неспожитим (через merge)
+    Backpressure  // виробник чекає на місце не довше за backpressureTimeout;
+                  // 0 — одна спроба без очікування, новий елемент відкидається
+};
+
+struct QueueStats {
+    uint64_t enqueued;
+    uint64_t dropped;
+    uint64_t coalesced;
+    uint64_t highWater;
+};
+
+// Обмежена lock-free черга один-виробник/один-споживач.
+// Кожна комірка має лічильник послідовності: seq == pos — вільна для запису
+// позиції pos, seq == pos + 1 — готова до читання, kClaimed — захоплена.
+// Захоплення через CAS дозволяє виробнику безпечно викидати найстаріший
+// елемент (DropOldest) або доповнювати останній (Coalesce), не змагаючись
+// зі споживачем за ту саму комірку.
+template <typename T>
+class SpscQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscQueue<T> потребує trivially copyable T");
+
+public:
+    // Зливає from у into; повертає false, якщо елементи несумісні
+    using MergeFn = bool (*)(T& into, const T& from);
+
+    static const size_t kCacheLine = 64;
+
+    explicit SpscQueue(size_t capacity,
+                       OverflowPolicy policy = OverflowPolicy::DropOldest,
+                       MergeFn merge = nullptr,
+                       std::chrono::microseconds backpressureTimeout = std::chrono::microseconds(0))
+        : policy_(policy), merge_(merge), backpressureTimeout_(backpressureTimeout) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        slots_.reset(new Slot[cap]);
+        mask_ = cap - 1;
+        for (size_t i = 0; i < cap; i++)
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+    OverflowPolicy policy() const { return policy_; }
+
+    size_t size() const {
+        uint64_t t = tail_.load(std::memory_order_acquire);
+        uint64_t h = head_.load(std::memory_order_acquire);
+        return t > h ? static_cast<size_t>(t - h) : 0;
+    }
+    bool empty() const { return size() == 0; }
+
+    // Лише з потоку-виробника. Повертає false, лише якщо елемент втрачено;
+    // злитий з попереднім елемент вважається прийнятим.
+    bool push(const T& item) {
+        if (tryPublish(item)) return true;
+
+        switch (policy_) {
+        case OverflowPolicy::DropOldest:
+            for (;;) {
+                if (tryDropOldest())
+                    producer_.dropped.fetch_add(1, std::memory_order_relaxed);
+                if (tryPublish(item)) return true;
+            }
+        case OverflowPolicy::Coalesce:
+            for (;;) {
+                int r = tryCoalesce(item);
+                if (r > 0) {
+                    producer_.coalesced.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                if (r < 0) break; // несумісні — відкидаємо новий
+                // Споживач саме забрав останній елемент — отже, місце з'явилося
+                if (tryPublish(item)) return true;
+            }
+            producer_.dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        case OverflowPolicy::Backpressure:
+            if (backpressureTimeout_.count() > 0) {
+                auto deadline = std::chrono::steady_clock::now() + backpressureTimeout_;
+                for (unsigned spins = 0;; spins++) {
+                    if (tryPublish(item)) return true;
+                    if (spins > 64) {
+                        if (std::chrono::steady_clock::now() >= deadline) break;
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            producer_.dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return false;
+    }
+
+    // Як push(), але спершу зливає item з останнім неспожитим елементом через
+    // merge, незалежно від заповненості: потік однорідних елементів займає
+    // одну комірку, доки споживач її не забрав.
+    bool pushMerged(const T& item) {
+        if (tryCoalesce(item) > 0) {
+            producer_.coalesced.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return push(item);
+    }
+
+    // Лише з потоку-споживача
+    bool pop(T& out) {
+        for (;;) {
+            uint64_t pos = head_.load(std::memory_order_acquire);
+            Slot& s = slots_[pos & mask_];
+            uint64_t seq = s.seq.load(std::memory_order_acquire);
+            if (seq == kClaimed) {
+                // Виробник доповнює цей елемент — це займає лічені наносекунди
+                std::this_thread::yield();
+                continue;
+            }
+            if (seq != pos + 1) {
+                if (seq < pos + 1) return false; // порожньо
+                continue;                        // виробник викинув елемент, head зсунувся
+            }
+            if (!s.seq.compare_exchange_strong(seq, kClaimed, std::memory_order_acquire))
+                continue;
+            out = s.value;
+            release(s, pos);
+            return true;
+        }
+    }
+
+    QueueStats stats() const {
+        return {producer_.enqueued.load(std::memory_order_relaxed),
+                producer_.dropped.load(std::memory_order_relaxed),
+                producer_.coalesced.load(std::memory_order_relaxed),
+                producer_.highWater.load(std::memory_order_relaxed)};
+    }
+
+private:
+    static const uint64_t kClaimed = ~static_cast<uint64_t>(0);
+
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        T value;
+    };
+
+    bool tryPublish(const T& item) {
+        uint64_t pos = tail_.load(std::memory_order_relaxed);
+        Slot& s = slots_[pos & mask_];
+        if (s.seq.load(std::memory_order_acquire) != pos) return false;
+        s.value = item;
+        s.seq.store(pos + 1, std::memory_order_release);
+        tail_.store(pos + 1, std::memory_order_seq_cst);
+
+        producer_.enqueued.fetch_add(1, std::memory_order_relaxed);
+        uint64_t depth = pos + 1 - head_.load(std::memory_order_relaxed);
+        if (depth > producer_.highWater.load(std::memory_order_relaxed))
+            producer_.highWater.store(depth, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool tryDropOldest() {
+        uint64_t pos = head_.load(std::memory_order_acquire);
+        Slot& s = slots_[pos & mask_];
+        uint64_t expected = pos + 1;
+        if (!s.seq.compare_exchange_strong(expected, kClaimed, std::memory_order_acquire))
+            return false;
+        release(s, pos);
+        return true;
+    }
+
+    // 1 — злито, 0 — останній елемент уже забрано, -1 — merge відмовив
+    int tryCoalesce(const T& item) {
+        if (!merge_) return -1;
+        uint64_t last = tail_.load(std::memory_order_relaxed) - 1;
+        Slot& s = slots_[last & mask_];
+        uint64_t expected = last + 1;
+        if (!s.seq.compare_exchange_strong(expected, kClaimed, std::memory_order_acquire))
+            return 0;
+        bool merged = merge_(s.value, item);
+        s.seq.store(last + 1, std::memory_order_release);
+        return merged ? 1 : -1;
+    }
+
+    void release(Slot& s, uint64_t pos) {
+        head_.store(pos + 1, std::memory_order_release);
+        s.seq.store(pos + mask_ + 1, std::memory_order_release);
+    }
+
+    struct alignas(kCacheLine) ProducerCounters {
+        std::atomic<uint64_t> enqueued{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> coalesced{0};
+        std::atomic<uint64_t> highWater{0};
+    };
+
+    alignas(kCacheLine) std::atomic<uint64_t> head_{0};
+    alignas(kCacheLine) std::atomic<uint64_t> tail_{0};
+    ProducerCounters producer_;
+    alignas(kCacheLine) std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    OverflowPolicy policy_;
+    MergeFn merge_;
+    std::chrono::microseconds backpressureTimeout_;
+};
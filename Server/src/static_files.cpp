@@ -0,0 +1,210 @@
+#include "static_files.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstdio>
+
+#ifdef REMOTECONTROL_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+const int kMaxDepth = 8;
+
+struct TypeEntry {
+    const char* ext;
+    const char* type;
+};
+
+const TypeEntry kTypes[] = {
+    {"html", "text/html; charset=utf-8"},
+    {"htm", "text/html; charset=utf-8"},
+    {"css", "text/css; charset=utf-8"},
+    {"js", "text/javascript; charset=utf-8"},
+    {"mjs", "text/javascript; charset=utf-8"},
+    {"json", "application/json"},
+    {"webmanifest", "application/manifest+json"},
+    {"txt", "text/plain; charset=utf-8"},
+    {"svg", "image/svg+xml"},
+    {"png", "image/png"},
+    {"jpg", "image/jpeg"},
+    {"jpeg", "image/jpeg"},
+    {"gif", "image/gif"},
+    {"webp", "image/webp"},
+    {"ico", "image/x-icon"},
+    {"wasm", "application/wasm"},
+    {"woff2", "font/woff2"},
+};
+
+// Сильний ETag із вмісту: кеш живе до перезапуску, тож mtime тут нічого не додає
+std::string contentEtag(const std::string& data, const char* suffix) {
+    uint64_t h = 14695981039346656037ull; // FNV-1a
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    char buf[40];
+    snprintf(buf, sizeof(buf), "\"%016llx%s\"", static_cast<unsigned long long>(h), suffix);
+    return buf;
+}
+
+bool readFile(const std::string& path, uint64_t size, std::string& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    out.resize(static_cast<size_t>(size));
+    size_t n = size ? fread(&out[0], 1, out.size(), f) : 0;
+    fclose(f);
+    return n == out.size();
+}
+
+#ifdef REMOTECONTROL_HAVE_ZLIB
+// Уже стиснені формати (png, jpeg, woff2...) gzip лише збільшує
+bool compressible(std::string_view type) {
+    return type.compare(0, 5, "text/") == 0 || type == "application/json"
+        || type == "application/manifest+json" || type == "image/svg+xml"
+        || type == "application/wasm" || type == "image/x-icon";
+}
+
+// gzip з максимальним рівнем: стискається один раз під час старту
+std::string gzipCompress(const std::string& data) {
+    z_stream zs = {};
+    if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+        return std::string();
+    std::string out(deflateBound(&zs, static_cast<uLong>(data.size())), '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in = static_cast<uInt>(data.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    int rc = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return rc == Z_STREAM_END ? out : std::string();
+}
+#endif
+
+} // namespace
+
+std::string_view StaticFileCache::contentTypeFor(std::string_view name) {
+    size_t dot = name.rfind('.');
+    if (dot != std::string_view::npos) {
+        std::string_view ext = name.substr(dot + 1);
+        for (const TypeEntry& t : kTypes) {
+            std::string_view e(t.ext);
+            if (e.size() != ext.size()) continue;
+            bool same = true;
+            for (size_t i = 0; i < e.size() && same; i++) {
+                char c = ext[i];
+                if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+                same = c == e[i];
+            }
+            if (same) return t.type;
+        }
+    }
+    return "application/octet-stream";
+}
+
+bool StaticFileCache::load(const std::string& root) {
+    files_.clear();
+    routes_.clear();
+    cachedBytes_ = gzipBytes_ = 0;
+#ifdef _WIN32
+    DWORD attrs = GetFileAttributesA(root.c_str());
+    if (attrs == INVALID_FILE_ATTRIBUTES || !(attrs & FILE_ATTRIBUTE_DIRECTORY)) return false;
+#else
+    struct stat st;
+    if (stat(root.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return false;
+#endif
+    scan(root, "", 0);
+    std::sort(routes_.begin(), routes_.end(),
+              [](const Route& a, const Route& b) { return a.url < b.url; });
+    return true;
+}
+
+// Приховані файли й каталоги (".git", ".DS_Store") не віддаються
+void StaticFileCache::scan(const std::string& dir, const std::string& url, int depth) {
+    if (depth > kMaxDepth) return;
+#ifdef _WIN32
+    WIN32_FIND_DATAA fd;
+    HANDLE h = FindFirstFileA((dir + "\\*").c_str(), &fd);
+    if (h == INVALID_HANDLE_VALUE) return;
+    do {
+        std::string name = fd.cFileName;
+        if (name.empty() || name[0] == '.') continue;
+        std::string path = dir + "\\" + name;
+        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            scan(path, url + "/" + name, depth + 1);
+        } else {
+            uint64_t size = (static_cast<uint64_t>(fd.nFileSizeHigh) << 32) | fd.nFileSizeLow;
+            addFile(path, url + "/" + name, size);
+        }
+    } while (FindNextFileA(h, &fd));
+    FindClose(h);
+#else
+    DIR* d = opendir(dir.c_str());
+    if (!d) return;
+    while (struct dirent* e = readdir(d)) {
+        std::string name = e->d_name;
+        if (name.empty() || name[0] == '.') continue;
+        std::string path = dir + "/" + name;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode))
+            scan(path, url + "/" + name, depth + 1);
+        else if (S_ISREG(st.st_mode))
+            addFile(path, url + "/" + name, static_cast<uint64_t>(st.st_size));
+    }
+    closedir(d);
+#endif
+}
+
+void StaticFileCache::addFile(const std::string& path, const std::string& url, uint64_t size) {
+    if (files_.size() == kMaxFiles) {
+        Logger::warning("Забагато файлів у веб-каталозі, пропущено: " + path);
+        return;
+    }
+    File f;
+    f.path = path;
+    f.contentType = contentTypeFor(url);
+    if (size <= kMaxCachedSize) {
+        if (!readFile(path, size, f.body)) {
+            Logger::warning("Не вдалося прочитати " + path);
+            return;
+        }
+        f.cached = true;
+        f.etag = contentEtag(f.body, "");
+#ifdef REMOTECONTROL_HAVE_ZLIB
+        if (compressible(f.contentType)) {
+            std::string gz = gzipCompress(f.body);
+            if (!gz.empty() && gz.size() < f.body.size()) {
+                f.gzipBody = std::move(gz);
+                f.gzipEtag = contentEtag(f.body, "-gz");
+                gzipBytes_ += f.gzipBody.size();
+            }
+        }
+#endif
+        cachedBytes_ += f.body.size();
+    }
+    size_t index = files_.size();
+    files_.push_back(std::move(f));
+    routes_.push_back({url, index});
+
+    // Каталог віддає свій index.html
+    const char kIndex[] = "/index.html";
+    const size_t kIndexLen = sizeof(kIndex) - 1;
+    if (url.size() >= kIndexLen && url.compare(url.size() - kIndexLen, kIndexLen, kIndex) == 0)
+        routes_.push_back({url.substr(0, url.size() - kIndexLen + 1), index});
+}
+
+const StaticFileCache::File* StaticFileCache::find(std::string_view urlPath) const {
+    auto it = std::lower_bound(routes_.begin(), routes_.end(), urlPath,
+                               [](const Route& r, std::string_view key) { return std::string_view(r.url) < key; });
+    if (it == routes_.end() || it->url != urlPath) return nullptr;
+    return &files_[it->file];
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Вміст веб-каталогу (Web/index.html тощо), завантажений один раз під час старту.
+// Файли до kMaxCachedSize лежать у пам'яті разом з ETag і, якщо вдалося
+// стиснути, gzip-варіантом; більші лише запам'ятовуються і віддаються
+// з диска через sendfile(). Після load() об'єкт лише читається, тож string_view
+// на вміст дійсні, доки він живий.
+class StaticFileCache {
+public:
+    static const size_t kMaxCachedSize = 1 << 20;
+    static const size_t kMaxFiles = 1024;
+
+    struct File {
+        std::string path;        // шлях на диску
+        std::string_view contentType;
+        bool cached = false;
+        // Лише для кешованих:
+        std::string body;
+        std::string etag;
+        std::string gzipBody;    // порожньо — стиснення не виграє або zlib недоступний
+        std::string gzipEtag;
+    };
+
+    // Читає каталог рекурсивно; false — каталог недоступний
+    bool load(const std::string& root);
+
+    // Файл за розкодованим шляхом URL ("/", "/index.html", "/img/a.png");
+    // для шляхів, що закінчуються на '/', — index.html у цьому каталозі
+    const File* find(std::string_view urlPath) const;
+
+    size_t fileCount() const { return files_.size(); }
+    size_t cachedBytes() const { return cachedBytes_; }
+    size_t gzipBytes() const { return gzipBytes_; }
+
+    static std::string_view contentTypeFor(std::string_view name);
+
+private:
+    struct Route {
+        std::string url;
+        size_t file;
+    };
+
+    void scan(const std::string& dir, const std::string& url, int depth);
+    void addFile(const std::string& path, const std::string& url, uint64_t size);
+
+    std::vector<File> files_;
+    std::vector<Route> routes_; // відсортовано за url для пошуку без виділень
+    size_t cachedBytes_ = 0;
+    size_t gzipBytes_ = 0;
+};
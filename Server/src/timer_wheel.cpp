@@ -0,0 +1,60 @@
+#include "timer_wheel.h"
+
+void TimerWheel::Timer::unlink() {
+    if (!next_) return;
+    prev_->next_ = next_;
+    next_->prev_ = prev_;
+    prev_ = next_ = nullptr;
+}
+
+TimerWheel::TimerWheel(std::chrono::milliseconds tick, size_t slotCount)
+    : tick_(tick.count() > 0 ? tick : std::chrono::milliseconds(1)) {
+    size_t n = 2;
+    while (n < slotCount) n <<= 1;
+    slots_.reset(new Timer[n]);
+    mask_ = n - 1;
+    for (size_t i = 0; i < n; i++)
+        slots_[i].prev_ = slots_[i].next_ = &slots_[i];
+    expired_.prev_ = expired_.next_ = &expired_;
+    nextTick_ = Clock::now() + tick_;
+}
+
+TimerWheel::~TimerWheel() {
+    // Від'єднуємо таймери, що пережили колесо, щоб їхні деструктори не чіпали слоти
+    for (size_t i = 0; i <= mask_; i++) {
+        while (slots_[i].next_ != &slots_[i]) slots_[i].next_->unlink();
+    }
+    while (expired_.next_ != &expired_) expired_.next_->unlink();
+}
+
+void TimerWheel::schedule(Timer& timer, std::chrono::milliseconds delay) {
+    timer.unlink();
+    // Таймер спрацює при обробці ticks-го наступного слота
+    uint64_t ticks = static_cast<uint64_t>((delay.count() + tick_.count() - 1) / tick_.count());
+    if (ticks == 0) ticks = 1;
+    uint64_t slotCount = mask_ + 1;
+    Timer& head = slots_[(cursor_ + ticks - 1) & mask_];
+    timer.rounds_ = (ticks - 1) / slotCount;
+    timer.prev_ = head.prev_;
+    timer.next_ = &head;
+    head.prev_->next_ = &timer;
+    head.prev_ = &timer;
+}
+
+void TimerWheel::collectSlot(size_t index) {
+    Timer& head = slots_[index];
+    Timer* t = head.next_;
+    while (t != &head) {
+        Timer* next = t->next_;
+        if (t->rounds_ == 0) {
+            t->unlink();
+            t->prev_ = expired_.prev_;
+            t->next_ = &expired_;
+            expired_.prev_->next_ = t;
+            expired_.prev_ = t;
+        } else {
+            t->rounds_--;
+        }
+        t = next;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Хешоване колесо таймерів (Varghese & Lauck): масив слотів по одному тіку,
+// у кожному — інтрузивний двозв'язний список таймерів. Постановка і
+// скасування — O(1), тік обходить лише один слот. Таймер, що чекає довше за
+// оберт колеса, має лічильник обертів. Призначене для одного (мережевого)
+// потоку: таймери спрацьовують усередині advance(), окремих потоків немає.
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Вбудовується у власника (наприклад, у з'єднання). Деструктор сам
+    // знімає таймер з колеса, тож власника можна знищити будь-коли.
+    class Timer {
+    public:
+        Timer() = default;
+        ~Timer() { unlink(); }
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        bool active() const { return next_ != nullptr; }
+        intptr_t owner = 0; // довільний ключ власника для обробника
+
+    private:
+        friend class TimerWheel;
+        void unlink();
+
+        Timer* prev_ = nullptr;
+        Timer* next_ = nullptr;
+        uint64_t rounds_ = 0;
+    };
+
+    explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(100),
+                        size_t slotCount = 512);
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    std::chrono::milliseconds tick() const { return tick_; }
+
+    // Ставить (або переставляє) таймер; точність — один тік
+    void schedule(Timer& timer, std::chrono::milliseconds delay);
+    void cancel(Timer& timer) { timer.unlink(); }
+
+    // Обробляє всі тіки до now і викликає onExpire(Timer&) для кожного
+    // таймера, що спрацював. Таймер знімається з колеса до виклику, тож
+    // обробник може переставити його або знищити власника.
+    template <typename F>
+    void advance(Clock::time_point now, F&& onExpire);
+
+private:
+    // Переносить таймери слота, час яких настав, у expired_
+    void collectSlot(size_t index);
+
+    std::chrono::milliseconds tick_;
+    std::unique_ptr<Timer[]> slots_; // голови кільцевих списків
+    size_t mask_;
+    size_t cursor_ = 0;              // наступний слот до обробки
+    Clock::time_point nextTick_;
+    Timer expired_;                  // голова списку таймерів, що спрацювали
+};
+
+template <typename F>
+void TimerWheel::advance(Clock::time_point now, F&& onExpire) {
+    while (nextTick_ <= now) {
+        collectSlot(cursor_);
+        cursor_ = (cursor_ + 1) & mask_;
+        nextTick_ += tick_;
+        while (expired_.next_ != &expired_) {
+            Timer* t = expired_.next_;
+            t->unlink();
+            onExpire(*t);
+        }
+    }
+}
@@ -0,0 +1,273 @@
+#include "tls.h"
+#include "logger.h"
+#include <climits>
+
+#ifdef REMOTECONTROL_HAVE_OPENSSL
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#ifndef _WIN32
+#include <csignal>
+#endif
+#endif
+
+namespace tls {
+
+namespace {
+
+#ifdef REMOTECONTROL_HAVE_OPENSSL
+
+// Квиток живе добу: телефон, що прокинувся, відновлює сесію одним RTT
+// без обчислень із сертифікатом. Ключі квитків випадкові на кожен запуск.
+const long kTicketLifetimeSec = 24 * 60 * 60;
+const char kSessionContext[] = "remotecontrol";
+
+std::string takeErrors() {
+    std::string out;
+    char buf[256];
+    while (unsigned long e = ERR_get_error()) {
+        ERR_error_string_n(e, buf, sizeof(buf));
+        if (!out.empty()) out += "; ";
+        out += buf;
+    }
+    return out.empty() ? "невідома помилка" : out;
+}
+
+int clampSize(size_t size) {
+    return size > static_cast<size_t>(INT_MAX) ? INT_MAX : static_cast<int>(size);
+}
+
+#endif
+
+} // namespace
+
+#ifdef REMOTECONTROL_HAVE_OPENSSL
+
+Context::Context() {}
+
+Context::~Context() {
+    if (ctx_) SSL_CTX_free(ctx_);
+}
+
+bool Context::load(const std::string& certFile, const std::string& keyFile) {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    if (!ctx) {
+        Logger::error("TLS: " + takeErrors());
+        return false;
+    }
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    // Частковий запис і "рухомий" буфер: черга кадрів повторює запис після
+    // EAGAIN з тієї ж позиції, але з нового тимчасового буфера
+    SSL_CTX_set_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+    // Без перепогодження запис ніколи не чекає читання; телефон, що зник без
+    // close_notify, — звичайне закриття, а не помилка
+    SSL_CTX_set_options(ctx, SSL_OP_NO_RENEGOTIATION);
+#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+    SSL_CTX_set_options(ctx, SSL_OP_IGNORE_UNEXPECTED_EOF);
+#endif
+
+    // Відновлення сесій: stateless tickets (TLS 1.3 і 1.2) плюс серверний кеш
+    // для клієнтів TLS 1.2 без квитків. 0-RTT не вмикаємо: натискання можна повторити.
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_set_session_id_context(ctx, reinterpret_cast<const unsigned char*>(kSessionContext),
+                                   sizeof(kSessionContext) - 1);
+    SSL_CTX_set_timeout(ctx, kTicketLifetimeSec);
+    SSL_CTX_set_num_tickets(ctx, 1);
+
+#ifdef SSL_OP_ENABLE_KTLS
+    // Шифрування записів у ядрі (модуль tls, AES-GCM); якщо ні — звичайний шлях
+    SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+#endif
+
+    if (SSL_CTX_use_certificate_chain_file(ctx, certFile.c_str()) != 1) {
+        Logger::error("TLS: не вдалося завантажити сертифікат " + certFile + ": " + takeErrors());
+        SSL_CTX_free(ctx);
+        return false;
+    }
+    if (SSL_CTX_use_PrivateKey_file(ctx, keyFile.c_str(), SSL_FILETYPE_PEM) != 1
+        || SSL_CTX_check_private_key(ctx) != 1) {
+        Logger::error("TLS: не вдалося завантажити ключ " + keyFile + ": " + takeErrors());
+        SSL_CTX_free(ctx);
+        return false;
+    }
+
+#ifndef _WIN32
+    // OpenSSL пише в сокет через write(), а не send(MSG_NOSIGNAL)
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    if (ctx_) SSL_CTX_free(ctx_);
+    ctx_ = ctx;
+    return true;
+}
+
+bool Context::shareTicketKeys(const Context& from) {
+    if (!ctx_ || !from.ctx_) return false;
+    // Ім'я (16 байтів), ключ HMAC і ключ AES (по 32) — формат SSL_CTRL_*_TLSEXT_TICKET_KEYS
+    unsigned char keys[80];
+    if (SSL_CTX_get_tlsext_ticket_keys(from.ctx_, keys, sizeof(keys)) != 1
+        || SSL_CTX_set_tlsext_ticket_keys(ctx_, keys, sizeof(keys)) != 1) {
+        Logger::error("TLS: не вдалося передати ключі квитків: " + takeErrors());
+        return false;
+    }
+    return true;
+}
+
+Session::Session(const Context& context, intptr_t fd) {
+    ssl_ = SSL_new(context.native());
+    if (!ssl_) return;
+    if (SSL_set_fd(ssl_, static_cast<int>(fd)) != 1) {
+        SSL_free(ssl_);
+        ssl_ = nullptr;
+        return;
+    }
+    SSL_set_accept_state(ssl_);
+}
+
+Session::~Session() {
+    if (ssl_) SSL_free(ssl_);
+}
+
+long long Session::result(int rc) {
+    int err = SSL_get_error(ssl_, rc);
+    wantsWrite_ = err == SSL_ERROR_WANT_WRITE;
+    switch (err) {
+    case SSL_ERROR_WANT_READ:
+    case SSL_ERROR_WANT_WRITE:
+        return kWouldBlock;
+    case SSL_ERROR_ZERO_RETURN:
+        return 0;
+    case SSL_ERROR_SYSCALL:
+        // Помилка сокета (ECONNRESET...), у черзі OpenSSL порожньо
+        if (ERR_peek_error() == 0) {
+            error_ = "з'єднання розірвано";
+            return kFailed;
+        }
+        break;
+    default:
+        break;
+    }
+    error_ = takeErrors();
+    return kFailed;
+}
+
+Session::Handshake Session::handshake() {
+    ERR_clear_error();
+    int rc = SSL_do_handshake(ssl_);
+    if (rc == 1) {
+        established_ = true;
+        wantsWrite_ = false;
+        kernelSend_ = BIO_get_ktls_send(SSL_get_wbio(ssl_)) != 0;
+        kernelRecv_ = BIO_get_ktls_recv(SSL_get_rbio(ssl_)) != 0;
+        return Handshake::Done;
+    }
+    long long r = result(rc);
+    if (r == kWouldBlock) return wantsWrite_ ? Handshake::WantWrite : Handshake::WantRead;
+    return Handshake::Failed;
+}
+
+long long Session::read(void* buf, size_t size) {
+    ERR_clear_error();
+    int rc = SSL_read(ssl_, buf, clampSize(size));
+    if (rc > 0) {
+        wantsWrite_ = false;
+        return rc;
+    }
+    return result(rc);
+}
+
+long long Session::write(const void* data, size_t size) {
+    ERR_clear_error();
+    int rc = SSL_write(ssl_, data, clampSize(size));
+    if (rc > 0) {
+        wantsWrite_ = false;
+        return rc;
+    }
+    return result(rc);
+}
+
+long long Session::sendFile(int file, uint64_t offset, size_t count) {
+#if !defined(OPENSSL_NO_KTLS) && !defined(_WIN32)
+    ERR_clear_error();
+    ossl_ssize_t n = SSL_sendfile(ssl_, file, static_cast<off_t>(offset), count, 0);
+    if (n >= 0) return n;
+    return result(static_cast<int>(n));
+#else
+    (void)file;
+    (void)offset;
+    (void)count;
+    error_ = "sendfile без kTLS";
+    return kFailed;
+#endif
+}
+
+bool Session::resumed() const {
+    return ssl_ && SSL_session_reused(ssl_) == 1;
+}
+
+std::string Session::describe() const {
+    if (!ssl_) return std::string();
+    std::string s = SSL_get_version(ssl_);
+    const char* cipher = SSL_get_cipher_name(ssl_);
+    if (cipher) s += std::string(" ") + cipher;
+    return s;
+}
+
+void Session::shutdown() {
+    if (ssl_ && established_) {
+        SSL_shutdown(ssl_);
+        ERR_clear_error();
+    }
+}
+
+#else
+
+Context::Context() {}
+
+Context::~Context() {}
+
+bool Context::load(const std::string&, const std::string&) {
+    Logger::error("TLS недоступний: сервер зібрано без OpenSSL");
+    return false;
+}
+
+bool Context::shareTicketKeys(const Context&) {
+    return false;
+}
+
+Session::Session(const Context&, intptr_t) {}
+
+Session::~Session() {}
+
+long long Session::result(int) {
+    return kFailed;
+}
+
+Session::Handshake Session::handshake() {
+    return Handshake::Failed;
+}
+
+long long Session::read(void*, size_t) {
+    return kFailed;
+}
+
+long long Session::write(const void*, size_t) {
+    return kFailed;
+}
+
+long long Session::sendFile(int, uint64_t, size_t) {
+    return kFailed;
+}
+
+bool Session::resumed() const {
+    return false;
+}
+
+std::string Session::describe() const {
+    return std::string();
+}
+
+void Session::shutdown() {}
+
+#endif
+
+} // namespace tls
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct ssl_ctx_st;
+struct ssl_st;
+
+// TLS для wss:// і https:// поверх неблокуючих сокетів (OpenSSL). Без OpenSSL
+// (REMOTECONTROL_HAVE_OPENSSL) Context::load() завжди повертає false.
+namespace tls {
+
+// Результати read/write/sendFile, крім кількості байтів
+const long long kWouldBlock = -1;  // чекати подію сокета (див. Session::wantsWrite)
+const long long kFailed = -2;      // з'єднання непридатне
+
+class Context {
+public:
+    Context();
+    ~Context();
+
+    Context(const Context&) = delete;
+    Context& operator=(const Context&) = delete;
+
+    // Сертифікат (PEM, можна з ланцюжком) і приватний ключ. Вмикає session
+    // tickets (повторне підключення без повного handshake) і kTLS, якщо
+    // його підтримують OpenSSL і ядро.
+    bool load(const std::string& certFile, const std::string& keyFile);
+    bool loaded() const { return ctx_ != nullptr; }
+    // Ключі квитків з іншого контексту: квиток, виданий одним шардом,
+    // приймає будь-який. Обидва контексти мають бути завантажені.
+    bool shareTicketKeys(const Context& from);
+
+    ssl_ctx_st* native() const { return ctx_; }
+
+private:
+    ssl_ctx_st* ctx_ = nullptr;
+};
+
+class Session {
+public:
+    enum class Handshake {
+        Done,
+        WantRead,
+        WantWrite,
+        Failed
+    };
+
+    // fd має бути неблокуючим; сокет не закривається сесією
+    Session(const Context& context, intptr_t fd);
+    ~Session();
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    bool valid() const { return ssl_ != nullptr; }
+
+    Handshake handshake();
+    bool established() const { return established_; }
+
+    // > 0 — байтів, 0 — клієнт закрив з'єднання, kWouldBlock, kFailed
+    long long read(void* buf, size_t size);
+    // Після kWouldBlock повторювати з тими самими байтами на початку (довжина може зрости)
+    long long write(const void* data, size_t size);
+    // Лише з kernelSend(): файл шифрує ядро, без копії в user space
+    long long sendFile(int file, uint64_t offset, size_t count);
+
+    // Остання операція чекає Writable (запис під час handshake або читання)
+    bool wantsWrite() const { return wantsWrite_; }
+    bool resumed() const;
+    bool kernelSend() const { return kernelSend_; }
+    bool kernelRecv() const { return kernelRecv_; }
+    // "TLSv1.3 TLS_AES_128_GCM_SHA256" для логу
+    std::string describe() const;
+    // Помилка останньої операції з черги OpenSSL
+    const std::string& error() const { return error_; }
+
+    // close_notify без очікування відповіді
+    void shutdown();
+
+private:
+    long long result(int rc);
+
+    ssl_st* ssl_ = nullptr;
+    bool established_ = false;
+    bool wantsWrite_ = false;
+    bool kernelSend_ = false;
+    bool kernelRecv_ = false;
+    std::string error_;
+};
+
+} // namespace tls
@@ -1,23 +1,51 @@
 #include "websocket_server.h"
+#include "event_poller.h"
+#include "http_parser.h"
+#include "static_files.h"
+#include "tls.h"
+#include "ws_deflate.h"
+#include "ws_frame_parser.h"
+#include "ws_frame_writer.h"
+#include "latency_stats.h"
 #include "logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
 #include <cstring>
-#include <sstream>
+#include <deque>
 
 #ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
 #pragma comment(lib, "ws2_32.lib")
 #define close_socket closesocket
 typedef SOCKET socket_fd_t;
 #define INVALID_FD INVALID_SOCKET
+#define SHUT_RDWR SD_BOTH
 #else
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <poll.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/sendfile.h>
+#endif
 #define close_socket close
 typedef int socket_fd_t;
 #define INVALID_FD (-1)
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
 #endif
 
 #if __APPLE__
@@ -25,44 +53,407 @@ typedef int socket_fd_t;
 #else
 #include "sha1.h"
 #endif
+#include "base64.h"
 
 namespace {
 
 const char* wsMagic = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
 const size_t kFrameBufSize = 4096;
+const int kListenBacklog = SOMAXCONN;
+const int kMaxEvents = 64;
+const int kPollTimeoutMs = 100;   // не більше тіку колеса таймерів
+const std::chrono::milliseconds kTimerTick(100);
+const std::chrono::milliseconds kHandshakeTimeout(5000);    // на запит до upgrade і простій keep-alive
+const std::chrono::milliseconds kPingInterval(5000);  // ping, якщо від клієнта стільки нічого не було
+const std::chrono::milliseconds kIdleTimeout(15000);  // закриваємо, якщо не відповів і на ping
+const std::chrono::milliseconds kAcceptBackoff(200);  // пауза accept, коли скінчилися дескриптори
+const size_t kMaxOutputBytes = 256 * 1024; // межа черги відправки одного з'єднання
+const int kMaxIov = 32;                    // частин (заголовок/payload) на один gather-write
+const size_t kFileChunk = 256 * 1024;      // байтів файлу на один sendfile()
+const size_t kTlsRecord = 16 * 1024;       // найбільший запис TLS: стільки беремо на один SSL_write
+const ws::DeflateConfig kDeflateConfig;    // вікно 8 KiB, memLevel 7: ~96 KiB на потік стиснення
+
+// io_uring
+const unsigned kRingEntries = 256;
+const unsigned kRingBuffers = 256;         // наданих буферів для multishot recv, спільних для всіх з'єднань
+const size_t kRingBufferSize = kFrameBufSize;
+const int kMaxLinkedSends = 4;             // ланок sendmsg в одному ланцюжку з'єднання
+const int kMaxCompletions = 256;
+
+// Що завершилося: старші 32 біти user_data — операція, молодші — сокет
+enum RingOp : uint32_t {
+    RingAccept = 1,
+    RingWake,
+    RingRecv,
+    RingSend,
+    RingWritable
+};
+
+uint64_t ringData(RingOp op, intptr_t fd) {
+    return (static_cast<uint64_t>(op) << 32) | static_cast<uint32_t>(fd);
+}
+
+bool setNonBlocking(socket_fd_t fd) {
+#ifdef _WIN32
+    u_long mode = 1;
+    return ioctlsocket(fd, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+#endif
+}
+
+// Поточний потік лише на заданому CPU; на macOS прив'язки потоків немає
+bool pinThread(int cpu) {
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+bool wouldBlock() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+int socketError() {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+std::string socketErrorText(int err) {
+#ifdef _WIN32
+    return "код " + std::to_string(err);
+#else
+    return strerror(err);
+#endif
+}
+
+// accept() досить повторити: перервано сигналом або клієнт пішов з черги.
+// Решта помилок (EMFILE, ENFILE, ENOBUFS...) повторювалася б одразу ж.
+bool acceptRetryable(int err) {
+#ifdef _WIN32
+    return err == WSAEINTR || err == WSAECONNRESET;
+#else
+    return err == EINTR || err == ECONNABORTED || err == EPROTO;
+#endif
+}
+
+// Відповідь без виділень пам'яті: шматки дописуються у фіксований буфер
+struct FixedWriter {
+    char* data;
+    size_t capacity;
+    size_t size;
+
+    FixedWriter(char* buf, size_t cap) : data(buf), capacity(cap), size(0) {}
+
+    FixedWriter& operator<<(std::string_view s) {
+        size_t n = std::min(s.size(), capacity - size);
+        memcpy(data + size, s.data(), n);
+        size += n;
+        return *this;
+    }
+
+    FixedWriter& operator<<(uint64_t v) {
+        char buf[20];
+        auto r = std::to_chars(buf, buf + sizeof(buf), v);
+        return *this << std::string_view(buf, static_cast<size_t>(r.ptr - buf));
+    }
+};
 
-std::string base64Encode(const unsigned char* data, size_t len) {
-    static const char tbl[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    std::string out;
-    out.reserve((len + 2) / 3 * 4);
-    for (size_t i = 0; i < len; i += 3) {
-        unsigned int n = data[i] << 16;
-        if (i + 1 < len) n |= data[i + 1] << 8;
-        if (i + 2 < len) n |= data[i + 2];
-        out += tbl[(n >> 18) & 63];
-        out += tbl[(n >> 12) & 63];
-        out += (i + 1 < len) ? tbl[(n >> 6) & 63] : '=';
-        out += (i + 2 < len) ? tbl[n & 63] : '=';
+// Некешований файл веб-каталогу: дескриптор, розмір і mtime для ETag; -1 — не відкрився
+int openFile(const std::string& path, uint64_t& size, uint64_t& mtime) {
+#ifdef _WIN32
+    int fd = _open(path.c_str(), _O_RDONLY | _O_BINARY);
+    struct _stat64 st;
+    if (fd >= 0 && _fstat64(fd, &st) != 0) {
+        _close(fd);
+        return -1;
     }
-    return out;
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd >= 0 && (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))) {
+        close(fd);
+        return -1;
+    }
+#endif
+    if (fd < 0) return -1;
+    size = static_cast<uint64_t>(st.st_size);
+    mtime = static_cast<uint64_t>(st.st_mtime);
+    return fd;
+}
+
+void closeFile(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
+
+// Читає до size байтів файлу з offset; 0 — кінець файлу або помилка
+size_t readFileAt(int file, uint64_t offset, char* buf, size_t size) {
+#ifdef _WIN32
+    if (_lseeki64(file, static_cast<long long>(offset), SEEK_SET) < 0) return 0;
+    int got = _read(file, buf, static_cast<unsigned>(size));
+#else
+    ssize_t got = pread(file, buf, size, static_cast<off_t>(offset));
+#endif
+    return got > 0 ? static_cast<size_t>(got) : 0;
+}
+
+// Відправляє до count байтів файлу з offset без копіювання в user space, де це можливо.
+// Повертає відправлене; -1 — помилка сокета (EAGAIN перевіряє wouldBlock()),
+// 0 — файл закінчився раніше, ніж очікувалося.
+long long sendFileChunk(intptr_t sock, int file, uint64_t offset, size_t count) {
+#if defined(__linux__)
+    off_t off = static_cast<off_t>(offset);
+    return sendfile(static_cast<int>(sock), file, &off, count);
+#elif defined(__APPLE__)
+    off_t len = static_cast<off_t>(count);
+    if (sendfile(file, static_cast<int>(sock), static_cast<off_t>(offset), &len, nullptr, 0) < 0 && len == 0)
+        return -1;
+    return len;
+#else
+    char buf[16384];
+    size_t got = readFileAt(file, offset, buf, std::min(count, sizeof(buf)));
+    if (got == 0) return 0;
+#ifdef _WIN32
+    int sent = send(static_cast<SOCKET>(sock), buf, static_cast<int>(got), 0);
+#else
+    ssize_t sent = send(static_cast<int>(sock), buf, got, MSG_NOSIGNAL);
+#endif
+    return sent < 0 ? -1 : static_cast<long long>(sent);
+#endif
+}
+
+// Транспорт з'єднання: сокет напряму або через TLS-сесію. Повертають кількість
+// байтів, 0 (клієнт закрив з'єднання / файл скінчився), tls::kWouldBlock або tls::kFailed.
+#ifdef _WIN32
+typedef WSABUF IoPart;
+inline const char* partData(const IoPart& p) { return p.buf; }
+inline size_t partSize(const IoPart& p) { return p.len; }
+#else
+typedef struct iovec IoPart;
+inline const char* partData(const IoPart& p) { return static_cast<const char*>(p.iov_base); }
+inline size_t partSize(const IoPart& p) { return p.iov_len; }
+#endif
+
+inline void setPart(IoPart& p, const char* data, size_t size) {
+#ifdef _WIN32
+    p.buf = const_cast<char*>(data);
+    p.len = static_cast<ULONG>(size);
+#else
+    p.iov_base = const_cast<char*>(data);
+    p.iov_len = size;
+#endif
+}
+
+long long socketResult(long long n) {
+    if (n >= 0) return n;
+    return wouldBlock() ? tls::kWouldBlock : tls::kFailed;
+}
+
+long long transportRecv(intptr_t fd, tls::Session* tls, char* buf, size_t size) {
+    if (tls) return tls->read(buf, size);
+#ifdef _WIN32
+    return socketResult(recv(static_cast<SOCKET>(fd), buf, static_cast<int>(size), 0));
+#else
+    return socketResult(recv(static_cast<int>(fd), buf, size, 0));
+#endif
+}
+
+// more — за цими байтами одразу піде файл (MSG_MORE, лише без TLS)
+long long transportSend(intptr_t fd, tls::Session* tls, const IoPart* parts, int count, bool more) {
+    if (tls) {
+        if (count == 1) return tls->write(partData(parts[0]), partSize(parts[0]));
+        // SSL_write не вміє gather: збираємо один запис. Після kWouldBlock
+        // виклик повториться з тієї ж позиції черги, тож початок буде тим самим.
+        char record[kTlsRecord];
+        size_t used = 0;
+        for (int i = 0; i < count && used < sizeof(record); i++) {
+            size_t n = std::min(partSize(parts[i]), sizeof(record) - used);
+            memcpy(record + used, partData(parts[i]), n);
+            used += n;
+        }
+        return tls->write(record, used);
+    }
+#ifdef _WIN32
+    (void)more;
+    DWORD sentBytes = 0;
+    int rc = WSASend(static_cast<SOCKET>(fd), const_cast<IoPart*>(parts), static_cast<DWORD>(count), &sentBytes,
+                     0, nullptr, nullptr);
+    return socketResult(rc == 0 ? static_cast<long long>(sentBytes) : -1);
+#else
+    struct msghdr msg = {};
+    msg.msg_iov = const_cast<IoPart*>(parts);
+    msg.msg_iovlen = static_cast<decltype(msg.msg_iovlen)>(count);
+    int flags = MSG_NOSIGNAL;
+#ifdef MSG_MORE
+    if (more) flags |= MSG_MORE;
+#else
+    (void)more;
+#endif
+    return socketResult(sendmsg(static_cast<int>(fd), &msg, flags));
+#endif
+}
+
+long long transportSendFile(intptr_t fd, tls::Session* tls, int file, uint64_t offset, size_t count) {
+    if (!tls) return socketResult(sendFileChunk(fd, file, offset, count));
+    if (tls->kernelSend()) return tls->sendFile(file, offset, count);
+    char buf[kTlsRecord];
+    size_t got = readFileAt(file, offset, buf, std::min(count, sizeof(buf)));
+    if (got == 0) return 0;
+    return tls->write(buf, got);
+}
+
+// Відправка відповіді на handshake одним send(); неповна відправка — помилка
+bool sendRaw(intptr_t fd, tls::Session* tls, const char* data, size_t size) {
+    IoPart part;
+    setPart(part, data, size);
+    return transportSend(fd, tls, &part, 1, false) == static_cast<long long>(size);
+}
+
+// Заголовки й payload кадрів черги, починаючи з next-го, як частини gather-write
+// (не більше kMaxIov); next переходить на перший кадр, що не вмістився
+template <typename Queue>
+int gatherFrames(const Queue& out, size_t& next, IoPart* parts) {
+    int count = 0;
+    for (; next < out.size() && count + 2 <= kMaxIov; next++) {
+        const ws::OutFrame& f = *out[next].frame;
+        const char* chunks[2] = {reinterpret_cast<const char*>(f.header), f.payload.data()};
+        size_t sizes[2] = {f.headerSize, f.payload.size()};
+        size_t skip = out[next].offset;
+        for (int c = 0; c < 2; c++) {
+            size_t off = std::min(skip, sizes[c]);
+            skip -= off;
+            if (off == sizes[c]) continue;
+            setPart(parts[count++], chunks[c] + off, sizes[c] - off);
+        }
+    }
+    return count;
+}
+
+std::shared_ptr<const ws::OutFrame> closeFrame(uint16_t code) {
+    uint8_t payload[2] = {static_cast<uint8_t>(code >> 8), static_cast<uint8_t>(code)};
+    return ws::makeFrame(ws::OpClose, payload, code ? sizeof(payload) : 0);
+}
+
+const std::shared_ptr<const ws::OutFrame>& pingFrame() {
+    static const std::shared_ptr<const ws::OutFrame> frame = ws::makeFrame(ws::OpPing, nullptr, 0);
+    return frame;
+}
+
+// RFC 6455 §4.2.1: ключ — це 16 випадкових байтів у base64, тобто рівно 24 символи
+bool isValidKey(std::string_view key) {
+    const size_t kNonceSize = 16;
+    if (key.size() != base64::encodedSize(kNonceSize)) return false;
+    uint8_t nonce[base64::maxDecodedSize(base64::encodedSize(kNonceSize))];
+    size_t n = 0;
+    return base64::decode(key.data(), key.size(), nonce, n) && n == kNonceSize;
 }
 
 } // namespace
 
-std::string WebSocketServer::computeAcceptKey(const std::string& key) {
-    std::string input = key + wsMagic;
+void WebSocketServer::computeAcceptKey(std::string_view key, char out[kAcceptKeySize]) {
 #if __APPLE__
-    unsigned char hashBuf[20];
-    CC_SHA1(input.data(), static_cast<CC_LONG>(input.size()), hashBuf);
-    return base64Encode(hashBuf, 20);
+    unsigned char digest[CC_SHA1_DIGEST_LENGTH];
+    CC_SHA1_CTX ctx;
+    CC_SHA1_Init(&ctx);
+    CC_SHA1_Update(&ctx, key.data(), static_cast<CC_LONG>(key.size()));
+    CC_SHA1_Update(&ctx, wsMagic, static_cast<CC_LONG>(strlen(wsMagic)));
+    CC_SHA1_Final(digest, &ctx);
 #else
-    std::string hashBin = sha1::hash(input);
-    return base64Encode(reinterpret_cast<const unsigned char*>(hashBin.data()), hashBin.size());
+    uint8_t digest[sha1::kDigestSize];
+    sha1::Context ctx;
+    ctx.update(key.data(), key.size());
+    ctx.update(wsMagic, strlen(wsMagic));
+    ctx.final(digest);
 #endif
+    base64::encode(digest, sizeof(digest), out);
 }
 
+struct WebSocketServer::Connection {
+    intptr_t fd;
+    std::string ip;
+    bool upgraded = false;
+    std::unique_ptr<tls::Session> tls;         // wss:// і https://, якщо сервер має сертифікат
+    bool tlsWantsWrite = false;                // читанню TLS потрібен Writable
+    std::unique_ptr<http::RequestParser> http; // розбір HTTP-запиту до завершення handshake
+    ws::FrameParser parser{kFrameBufSize};
+    std::unique_ptr<ws::DeflateSession> deflate; // узгоджено permessage-deflate
+    uint64_t readableAt = 0; // latency::now() останнього сповіщення про дані
+    TimerWheel::Timer timer;  // дедлайн handshake, далі — періодична перевірка простою
+    TimerWheel::Clock::time_point lastActivity;
+
+    struct Pending {
+        std::shared_ptr<const ws::OutFrame> frame;
+        size_t offset; // скільки байтів кадру (заголовок + payload) вже відправлено
+    };
+    std::deque<Pending> out;
+    size_t outBytes = 0;
+    bool writeBlocked = false; // сокет повернув EAGAIN, чекаємо Writable
+    bool dirty = false;        // є в dirty_
+
+    // io_uring: операції в ядрі, що посилаються на з'єднання (recv, ланки
+    // sendmsg, poll); поки їх не 0, сокет не закривається
+    int ringOps = 0;
+    bool recvArmed = false;
+    int sendsInFlight = 0;
+
+    // Знімає з черги відправлені байти
+    void consumeOutput(size_t sent) {
+        outBytes -= sent;
+        while (sent > 0) {
+            Pending& p = out.front();
+            size_t left = p.frame->size() - p.offset;
+            if (sent < left) {
+                p.offset += sent;
+                break;
+            }
+            sent -= left;
+            out.pop_front();
+        }
+    }
+
+    // HTTP-відповідь у процесі відправки (лише до upgrade). Поки вона не піде,
+    // наступні запити не читаються: з'єднання чекає лише Writable.
+    struct Response {
+        char head[512];
+        size_t headSize = 0;
+        std::string_view body;  // з кешу веб-каталогу, живе весь час роботи сервера
+        size_t offset = 0;      // відправлено з head + body
+        int file = -1;          // некешований файл, віддається sendfile()
+        uint64_t fileOffset = 0;
+        uint64_t fileEnd = 0;
+        bool keepAlive = false;
+        bool blocked = false;   // сокет повернув EAGAIN
+
+        ~Response() {
+            if (file >= 0) closeFile(file);
+        }
+    };
+    std::unique_ptr<Response> response;
+};
+
 WebSocketServer::WebSocketServer(uint16_t port)
-    : port_(port), running_(false) {}
+    : port_(port), running_(false), timers_(kTimerTick) {}
 
 WebSocketServer::~WebSocketServer() {
     stop();
@@ -72,8 +463,216 @@ void WebSocketServer::setMessageCallback(MessageCallback callback) {
     messageCallback_ = std::move(callback);
 }
 
+void WebSocketServer::setBinaryCallback(BinaryCallback callback) {
+    binaryCallback_ = std::move(callback);
+}
+
+void WebSocketServer::setCloseCallback(CloseCallback callback) {
+    closeCallback_ = std::move(callback);
+}
+
+bool WebSocketServer::setWebRoot(const std::string& dir) {
+    std::unique_ptr<StaticFileCache> files(new StaticFileCache());
+    if (!files->load(dir)) {
+        Logger::error("Веб-каталог недоступний: " + dir);
+        return false;
+    }
+    Logger::info("Веб-каталог " + dir + ": файлів " + std::to_string(files->fileCount())
+                 + ", у пам'яті " + std::to_string(files->cachedBytes())
+                 + " B, gzip " + std::to_string(files->gzipBytes()) + " B");
+    files_ = std::move(files);
+    return true;
+}
+
+bool WebSocketServer::setTls(const std::string& certFile, const std::string& keyFile) {
+    std::unique_ptr<tls::Context> context(new tls::Context());
+    if (!context->load(certFile, keyFile)) return false;
+    Logger::info("TLS увімкнено: " + certFile);
+    tls_ = std::move(context);
+    return true;
+}
+
+bool WebSocketServer::shareTlsTickets(const WebSocketServer& from) {
+    return tls_ && from.tls_ && tls_->shareTicketKeys(*from.tls_);
+}
+
+bool WebSocketServer::sendText(ConnectionId id, const std::string& text) {
+    return sendFrame(id, ws::makeFrame(ws::OpText, text.data(), text.size()));
+}
+
+bool WebSocketServer::sendBinary(ConnectionId id, const uint8_t* data, size_t size) {
+    return sendFrame(id, ws::makeFrame(ws::OpBinary, data, size));
+}
+
+void WebSocketServer::broadcastText(const std::string& text) {
+    sendFrame(kNoConnection, ws::makeFrame(ws::OpText, text.data(), text.size()));
+}
+
+void WebSocketServer::broadcastBinary(const uint8_t* data, size_t size) {
+    sendFrame(kNoConnection, ws::makeFrame(ws::OpBinary, data, size));
+}
+
+bool WebSocketServer::sendFrame(ConnectionId id, FramePtr frame) {
+    if (std::this_thread::get_id() != networkThread_.load(std::memory_order_acquire)) {
+        // Чужий потік: передаємо мережевому через outbox і будимо його
+        std::lock_guard<std::mutex> lock(outboxMutex_);
+        if (!poller_) return false;
+        outbox_.emplace_back(id, std::move(frame));
+        poller_->wake();
+        return true;
+    }
+    if (id == kNoConnection) {
+        for (auto& entry : connections_) {
+            if (entry.second->upgraded) queueFrame(*entry.second, frame);
+        }
+        return true;
+    }
+    auto it = connections_.find(id);
+    if (it == connections_.end() || !it->second->upgraded) return false;
+    return queueFrame(*it->second, frame);
+}
+
+bool WebSocketServer::queueFrame(Connection& conn, const FramePtr& frame) {
+    // Ліміт перевіряється до стиснення: відкинутий після deflate кадр
+    // розсинхронізував би контекст із клієнтом
+    if (conn.outBytes + frame->size() > kMaxOutputBytes) {
+        Logger::warning("Черга відправки переповнена, кадр для " + conn.ip + " відкинуто");
+        return false;
+    }
+    FramePtr out = frame;
+    ws::Opcode op = frame->opcode();
+    if (conn.deflate && (op == ws::OpText || op == ws::OpBinary) && !frame->compressed()
+        && conn.deflate->shouldCompress(frame->payload.size())) {
+        std::string packed;
+        if (conn.deflate->compress(frame->payload.data(), frame->payload.size(), packed))
+            out = ws::makeFrame(op, std::move(packed), true);
+    }
+    conn.out.push_back({out, 0});
+    conn.outBytes += out->size();
+    if (!conn.dirty) {
+        conn.dirty = true;
+        dirty_.push_back(conn.fd);
+    }
+    return true;
+}
+
+// Відправляє чергу з'єднання gather-write'ами (заголовок і payload кожного
+// кадру — окремі iovec), доки сокет приймає. Повертає false при помилці сокета.
+bool WebSocketServer::flushOutput(Connection& conn, EventPoller& poller) {
+    if (ring_.opened()) return submitOutput(conn);
+    while (!conn.out.empty()) {
+        IoPart parts[kMaxIov];
+        size_t next = 0;
+        int count = gatherFrames(conn.out, next, parts);
+
+        long long n = transportSend(conn.fd, conn.tls.get(), parts, count, false);
+        if (n == tls::kFailed) return false;
+        if (n == tls::kWouldBlock) {
+            if (!conn.writeBlocked) {
+                conn.writeBlocked = true;
+                poller.modify(conn.fd, EventPoller::Readable | EventPoller::Writable);
+            }
+            return true;
+        }
+
+        conn.consumeOutput(static_cast<size_t>(n));
+    }
+    if (conn.writeBlocked) {
+        conn.writeBlocked = false;
+        poller.modify(conn.fd, EventPoller::Readable);
+    }
+    return true;
+}
+
+// io_uring: черга з'єднання йде ланцюжком sendmsg (IOSQE_IO_LINK), по kMaxIov
+// частин на ланку. З MSG_WAITALL ядро саме дописує частково прийняте, тож
+// ланка завершується лише повністю відправленою, а наступна стартує після неї.
+// Поки ланцюжок у ядрі, нові кадри лише стають у чергу за ним.
+bool WebSocketServer::submitOutput(Connection& conn) {
+#ifdef _WIN32
+    (void)conn;
+    return false;
+#else
+    if (conn.sendsInFlight > 0 || conn.out.empty()) return true;
+    if (!ring_.reserve(kMaxLinkedSends)) return false;
+    size_t next = 0;
+    for (int i = 0; i < kMaxLinkedSends && next < conn.out.size(); i++) {
+        IoPart parts[kMaxIov];
+        int count = gatherFrames(conn.out, next, parts);
+        bool link = i + 1 < kMaxLinkedSends && next < conn.out.size();
+        if (!ring_.sendmsg(conn.fd, parts, count, MSG_NOSIGNAL | MSG_WAITALL, link, ringData(RingSend, conn.fd)))
+            return false;
+        conn.sendsInFlight++;
+        conn.ringOps++;
+    }
+    return true;
+#endif
+}
+
+// Завершилася ланка ланцюжка; коли завершаться всі — наступний ланцюжок
+bool WebSocketServer::onRingSent(Connection& conn, int32_t result) {
+    conn.sendsInFlight--;
+    if (result > 0)
+        conn.consumeOutput(static_cast<size_t>(result));
+    else if (result < 0 && result != -ECANCELED) // -ECANCELED: попередня ланка не дописала, повторимо
+        return false;
+    return conn.sendsInFlight > 0 || submitOutput(conn);
+}
+
+// Таймер з'єднання: до handshake — дедлайн, після — перевірка простою раз на kPingInterval
+void WebSocketServer::onTimer(intptr_t clientFd, EventPoller& poller) {
+    auto it = connections_.find(clientFd);
+    if (it == connections_.end()) return;
+    Connection& conn = *it->second;
+    if (!conn.upgraded) {
+        // Повільний клієнт, що таки забирає велику відповідь, не обриваємо
+        auto idle = TimerWheel::Clock::now() - conn.lastActivity;
+        if (conn.response && idle < kHandshakeTimeout) {
+            timers_.schedule(conn.timer, std::chrono::duration_cast<std::chrono::milliseconds>(kHandshakeTimeout - idle));
+            return;
+        }
+        Logger::warning("Таймаут HTTP-запиту: " + conn.ip);
+        closeConnection(clientFd, poller);
+        return;
+    }
+    auto idle = TimerWheel::Clock::now() - conn.lastActivity;
+    if (idle >= kIdleTimeout) {
+        Logger::warning("Клієнт не відповідає, закриваємо з'єднання: " + conn.ip);
+        closeConnection(clientFd, poller);
+        return;
+    }
+    if (idle >= kPingInterval) queueFrame(conn, pingFrame());
+    timers_.schedule(conn.timer, kPingInterval);
+}
+
+// Забирає кадри інших потоків і відправляє все, що назбиралося за ітерацію
+void WebSocketServer::flushPending(EventPoller& poller) {
+    std::vector<std::pair<ConnectionId, FramePtr>> outbox;
+    {
+        std::lock_guard<std::mutex> lock(outboxMutex_);
+        outbox.swap(outbox_);
+    }
+    for (auto& item : outbox)
+        sendFrame(item.first, std::move(item.second));
+
+    std::vector<intptr_t> dirty;
+    dirty.swap(dirty_);
+    for (intptr_t fd : dirty) {
+        auto it = connections_.find(fd);
+        if (it == connections_.end()) continue;
+        Connection& conn = *it->second;
+        conn.dirty = false;
+        if (!conn.writeBlocked && !flushOutput(conn, poller))
+            closeConnection(fd, poller);
+    }
+}
+
 void WebSocketServer::start() {
     if (running_) return;
+    if (compression_ && !deflatePool_) {
+        deflatePool_.reset(new ws::DeflatePool(kDeflateConfig.level, kDeflateConfig.memLevel));
+        inflateBuf_.reset(new uint8_t[ws::FrameParser::kDefaultMaxMessageSize]);
+    }
     running_ = true;
     workerThread_ = std::thread(&WebSocketServer::run, this);
 }
@@ -85,6 +684,9 @@ void WebSocketServer::stop() {
 }
 
 void WebSocketServer::run() {
+    if (cpu_ >= 0 && !pinThread(cpu_))
+        Logger::warning("Не вдалося закріпити мережевий потік за CPU " + std::to_string(cpu_));
+
     socket_fd_t listenFd = socket(AF_INET, SOCK_STREAM, 0);
     if (listenFd == INVALID_FD) {
         Logger::error("Помилка створення сокета");
@@ -99,6 +701,22 @@ void WebSocketServer::run() {
         running_ = false;
         return;
     }
+#ifdef SO_REUSEPORT
+    if (reusePort_
+        && setsockopt(listenFd, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<const char*>(&opt), sizeof(opt)) < 0) {
+        Logger::error("setsockopt SO_REUSEPORT");
+        close_socket(listenFd);
+        running_ = false;
+        return;
+    }
+#else
+    if (reusePort_) {
+        Logger::error("SO_REUSEPORT недоступний на цій платформі");
+        close_socket(listenFd);
+        running_ = false;
+        return;
+    }
+#endif
 
     struct sockaddr_in addr;
     memset(&addr, 0, sizeof(addr));
@@ -113,134 +731,753 @@ void WebSocketServer::run() {
         return;
     }
 
-    if (listen(listenFd, 1) < 0) {
+    if (listen(listenFd, kListenBacklog) < 0 || !setNonBlocking(listenFd)) {
         Logger::error("Помилка listen");
         close_socket(listenFd);
         running_ = false;
         return;
     }
 
-    Logger::info("WebSocket сервер слухає на порту " + std::to_string(port_));
+#ifdef REMOTECONTROL_HAVE_IO_URING
+    // OpenSSL читає й пише сокет сам, тож TLS лишається на epoll
+    if (ioUring_ && !tls_ && !ring_.open(kRingEntries, kRingBuffers, kRingBufferSize))
+        Logger::warning("io_uring недоступний (" + ring_.error() + "), працюємо на " + EventPoller::backendName());
+#endif
+
+    // З io_uring EventPoller лишається лише для wake()
+    EventPoller poller;
+    if (!poller.open()
+        || (!ring_.opened() && !poller.add(static_cast<intptr_t>(listenFd), EventPoller::Readable))) {
+        Logger::error("Помилка ініціалізації " + std::string(EventPoller::backendName()));
+        ring_.close();
+        close_socket(listenFd);
+        running_ = false;
+        return;
+    }
+
+    Logger::info("WebSocket сервер слухає на порту " + std::to_string(port_)
+                 + " (" + (ring_.opened() ? IoRing::backendName() : EventPoller::backendName())
+                 + (tls_ ? ", TLS" : "") + (cpu_ >= 0 ? ", CPU " + std::to_string(cpu_) : "") + ")");
+
+    networkThread_.store(std::this_thread::get_id(), std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(outboxMutex_);
+        poller_ = &poller;
+    }
+
+    if (ring_.opened())
+        ringLoop(static_cast<intptr_t>(listenFd), poller);
+    else
+        pollLoop(static_cast<intptr_t>(listenFd), poller);
+    running_ = false;
 
+    {
+        std::lock_guard<std::mutex> lock(outboxMutex_);
+        poller_ = nullptr;
+        outbox_.clear();
+    }
+    networkThread_.store(std::thread::id(), std::memory_order_release);
+    while (!connections_.empty()) {
+        Connection& conn = *connections_.begin()->second;
+        if (conn.upgraded) queueFrame(conn, closeFrame(1001)); // going away
+        closeConnection(conn.fd, poller);
+    }
+    dirty_.clear();
+    if (ring_.opened()) {
+        // Кільце звільняє файли асинхронно, і multishot accept тримав би порт
+        // зайнятим після виходу; shutdown знімає його з прослуховування одразу
+        shutdown(listenFd, SHUT_RDWR);
+        // Сокети закритих з'єднань ще тримають операції в ядрі; чекаємо їх недовго
+        auto deadline = TimerWheel::Clock::now() + std::chrono::seconds(1);
+        IoRing::Completion done[kMaxCompletions];
+        while (!closing_.empty() && TimerWheel::Clock::now() < deadline) {
+            int n = ring_.wait(done, kMaxCompletions, kPollTimeoutMs);
+            if (n < 0) break;
+            for (int i = 0; i < n; i++) onRingCompletion(done[i], static_cast<intptr_t>(listenFd), poller, 0);
+        }
+        ring_.close();
+        for (auto& entry : closing_) close_socket(static_cast<socket_fd_t>(entry.first));
+        closing_.clear();
+    }
+    poller.close();
+    close_socket(listenFd);
+}
+
+void WebSocketServer::pollLoop(intptr_t listenFd, EventPoller& poller) {
+    EventPoller::Event events[kMaxEvents];
+    while (running_) {
+        int n = poller.wait(events, kMaxEvents, kPollTimeoutMs);
+        if (n < 0) {
+            Logger::error("Помилка очікування подій сокетів");
+            break;
+        }
+        uint64_t readableAt = latency::now();
+        for (int i = 0; i < n; i++) {
+            intptr_t fd = events[i].fd;
+            if (fd == listenFd) {
+                acceptClients(fd, poller);
+                continue;
+            }
+            auto it = connections_.find(fd);
+            if (it == connections_.end()) continue;
+            Connection& conn = *it->second;
+            conn.readableAt = readableAt;
+            bool ok = true;
+            if ((events[i].events & EventPoller::Writable) && conn.tlsWantsWrite) {
+                conn.tlsWantsWrite = false;
+                if (!conn.writeBlocked) poller.modify(fd, EventPoller::Readable);
+                ok = handleClient(conn, poller);
+            }
+            if (ok && (events[i].events & EventPoller::Writable))
+                ok = conn.response ? resumeResponse(conn, poller) : flushOutput(conn, poller);
+            if (ok && (events[i].events & (EventPoller::Readable | EventPoller::Error)))
+                ok = handleClient(conn, poller);
+            if (!ok || (events[i].events & EventPoller::Error))
+                closeConnection(fd, poller);
+        }
+        timers_.advance(TimerWheel::Clock::now(), [this, listenFd, &poller](TimerWheel::Timer& t) {
+            if (&t == &acceptTimer_)
+                resumeAccept(listenFd, poller);
+            else
+                onTimer(t.owner, poller);
+        });
+        flushPending(poller);
+    }
+}
+
+// Цикл на io_uring: один io_uring_enter на ітерацію подає все, що назбиралося
+// (recv, ланцюжки sendmsg, poll), і забирає завершення. Нові з'єднання дає
+// multishot accept, пробудження з інших потоків — multishot poll на EventPoller.
+void WebSocketServer::ringLoop(intptr_t listenFd, EventPoller& poller) {
+    if (!ring_.acceptMultishot(listenFd, ringData(RingAccept, listenFd))
+        || !ring_.poll(poller.nativeHandle(), POLLIN, true, ringData(RingWake, 0))) {
+        Logger::error("Помилка подання в io_uring");
+        return;
+    }
+    IoRing::Completion done[kMaxCompletions];
     while (running_) {
+        int n = ring_.wait(done, kMaxCompletions, kPollTimeoutMs);
+        if (n < 0) {
+            Logger::error("Помилка очікування io_uring");
+            break;
+        }
+        uint64_t readableAt = latency::now();
+        for (int i = 0; i < n; i++) onRingCompletion(done[i], listenFd, poller, readableAt);
+        timers_.advance(TimerWheel::Clock::now(), [this, listenFd, &poller](TimerWheel::Timer& t) {
+            if (&t == &acceptTimer_)
+                resumeAccept(listenFd, poller);
+            else
+                onTimer(t.owner, poller);
+        });
+        flushPending(poller);
+    }
+}
+
+void WebSocketServer::onRingCompletion(const IoRing::Completion& c, intptr_t listenFd, EventPoller& poller,
+                                       uint64_t readableAt) {
+    RingOp op = static_cast<RingOp>(c.userData >> 32);
+    intptr_t fd = static_cast<int32_t>(c.userData & 0xffffffffu);
+    if (op == RingAccept) {
+        if (c.result >= 0 && !running_) {
+            close_socket(static_cast<socket_fd_t>(c.result));
+        } else if (c.result >= 0) {
+            struct sockaddr_in clientAddr;
+            socklen_t clientLen = sizeof(clientAddr);
+            char clientIp[INET_ADDRSTRLEN] = "?";
+            if (getpeername(static_cast<socket_fd_t>(c.result), (struct sockaddr*)&clientAddr, &clientLen) == 0)
+                inet_ntop(AF_INET, &clientAddr.sin_addr, clientIp, sizeof(clientIp));
+            Connection* conn = addClient(c.result, clientIp);
+            if (!armRecv(*conn)) closeConnection(conn->fd, poller);
+        } else if (running_ && !c.more && !acceptRetryable(-c.result)) {
+            // Multishot знято помилкою; ставити одразу не можна — при EMFILE
+            // ядро відхилило б його знову, і шард крутився б на завершеннях
+            pauseAccept(listenFd, poller, -c.result);
+            return;
+        }
+        if (!c.more && running_) ring_.acceptMultishot(listenFd, ringData(RingAccept, listenFd));
+        return;
+    }
+    if (op == RingWake) {
+        EventPoller::Event events[kMaxEvents];
+        poller.wait(events, kMaxEvents, 0); // лише знімає пробудження, сокетів у poller немає
+        if (!c.more) ring_.poll(poller.nativeHandle(), POLLIN, true, ringData(RingWake, 0));
+        return;
+    }
+
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) {
+        // З'єднання вже закрите: чекаємо, доки ядро відпустить сокет
+        if (c.buffer >= 0) ring_.releaseBuffer(c.buffer);
+        auto closing = closing_.find(fd);
+        if (closing != closing_.end() && !c.more && --closing->second->ringOps == 0) {
+            closing_.erase(closing);
+            close_socket(static_cast<socket_fd_t>(fd));
+        }
+        return;
+    }
+    Connection& conn = *it->second;
+    if (!c.more) conn.ringOps--;
+    bool ok = true;
+    switch (op) {
+    case RingRecv:
+        if (!c.more) conn.recvArmed = false;
+        if (c.result > 0) {
+            conn.readableAt = readableAt;
+            conn.lastActivity = TimerWheel::Clock::now();
+            // До upgrade дані вже в буфері запиту, після — у наданому буфері
+            if (c.buffer >= 0)
+                ok = feedFrames(conn, ring_.bufferData(c.buffer), static_cast<size_t>(c.result));
+            else
+                ok = processRequests(conn, poller, static_cast<size_t>(c.result));
+            ok = ok && armRecv(conn);
+        } else {
+            // -ENOBUFS: усі надані буфери зайняті, multishot знято — ставимо знову
+            ok = c.result == -ENOBUFS && armRecv(conn);
+        }
+        if (c.buffer >= 0) ring_.releaseBuffer(c.buffer);
+        break;
+    case RingSend:
+        ok = onRingSent(conn, c.result);
+        break;
+    case RingWritable:
+        ok = c.result >= 0 && resumeResponse(conn, poller);
+        break;
+    default:
+        break;
+    }
+    if (!ok) closeConnection(fd, poller);
+}
+
+void WebSocketServer::acceptClients(intptr_t listenFd, EventPoller& poller) {
+    for (;;) {
         struct sockaddr_in clientAddr;
         socklen_t clientLen = sizeof(clientAddr);
-        socket_fd_t clientFd = accept(listenFd, (struct sockaddr*)&clientAddr, &clientLen);
+        socket_fd_t clientFd = accept(static_cast<socket_fd_t>(listenFd), (struct sockaddr*)&clientAddr, &clientLen);
         if (clientFd == INVALID_FD) {
-            if (running_) Logger::error("Помилка accept");
-            break;
+            int err = socketError();
+            if (wouldBlock()) return;
+            if (acceptRetryable(err)) continue;
+            // Epoll чекає фронту, а черга listen може бути непорожньою:
+            // просто вийти означало б не прийняти її до наступного клієнта
+            pauseAccept(listenFd, poller, err);
+            return;
+        }
+        intptr_t fd = static_cast<intptr_t>(clientFd);
+#ifdef SO_NOSIGPIPE
+        int noSigPipe = 1;
+        setsockopt(clientFd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+        std::unique_ptr<tls::Session> session;
+        if (tls_) {
+            session.reset(new tls::Session(*tls_, fd));
+            if (!session->valid()) {
+                Logger::error("Не вдалося створити TLS-сесію");
+                close_socket(clientFd);
+                continue;
+            }
+        }
+        if (!setNonBlocking(clientFd) || !poller.add(fd, EventPoller::Readable)) {
+            Logger::error("Не вдалося зареєструвати клієнта");
+            close_socket(clientFd);
+            continue;
         }
 
         char clientIp[INET_ADDRSTRLEN];
         inet_ntop(AF_INET, &clientAddr.sin_addr, clientIp, sizeof(clientIp));
-        Logger::info("Клієнт підключено: " + std::string(clientIp));
-
-        if (doHandshake(static_cast<intptr_t>(clientFd))) {
-            handleClient(static_cast<intptr_t>(clientFd));
-        }
-        close_socket(clientFd);
-        Logger::info("Клієнт відключено, очікуємо нового...");
+        addClient(fd, clientIp)->tls = std::move(session);
     }
+}
 
-    close_socket(listenFd);
-    running_ = false;
+// Стійка помилка accept: ядро повертало б її на кожну спробу, тож сокет
+// прослуховування знімаємо з очікування (з io_uring — не ставимо accept
+// знову) і повертаємо через kAcceptBackoff.
+// У лог — раз на епізод, а не на кожну спробу.
+void WebSocketServer::pauseAccept(intptr_t listenFd, EventPoller& poller, int err) {
+    if (acceptError_ != err)
+        Logger::error("Помилка accept: " + socketErrorText(err) + ", нові з'єднання відкладено");
+    acceptError_ = err;
+    if (!ring_.opened()) poller.remove(listenFd);
+    timers_.schedule(acceptTimer_, kAcceptBackoff);
 }
 
-bool WebSocketServer::doHandshake(intptr_t clientFd) {
-    char buf[1024];
-#ifdef _WIN32
-    int n = recv(reinterpret_cast<SOCKET>(clientFd), buf, sizeof(buf) - 1, 0);
-#else
-    ssize_t n = recv(static_cast<int>(clientFd), buf, sizeof(buf) - 1, 0);
-#endif
-    if (n <= 0) return false;
-    buf[n] = '\0';
-    std::string request(buf);
+void WebSocketServer::resumeAccept(intptr_t listenFd, EventPoller& poller) {
+    if (ring_.opened()) {
+        if (!ring_.acceptMultishot(listenFd, ringData(RingAccept, listenFd)))
+            timers_.schedule(acceptTimer_, kAcceptBackoff);
+        return;
+    }
+    if (!poller.add(listenFd, EventPoller::Readable)) {
+        timers_.schedule(acceptTimer_, kAcceptBackoff);
+        return;
+    }
+    // Черга listen могла наповнитися за паузу, а фронту вже не буде
+    acceptClients(listenFd, poller);
+}
 
-    std::string key;
-    size_t pos = request.find("Sec-WebSocket-Key:");
-    if (pos != std::string::npos) {
-        pos = request.find_first_not_of(" \t", pos + 18);
-        size_t end = request.find("\r\n", pos);
-        if (end != std::string::npos)
-            key = request.substr(pos, end - pos);
+WebSocketServer::Connection* WebSocketServer::addClient(intptr_t fd, const char* ip) {
+    if (acceptError_) {
+        Logger::info("Прийом з'єднань відновлено");
+        acceptError_ = 0;
     }
-    if (key.empty()) {
-        Logger::error("Немає Sec-WebSocket-Key у запиті");
-        return false;
+    Logger::info("Клієнт підключено: " + std::string(ip)
+                 + " (активних: " + std::to_string(connections_.size() + 1) + ")");
+
+    std::unique_ptr<Connection> conn(new Connection());
+    conn->fd = fd;
+    conn->ip = ip;
+    conn->http.reset(new http::RequestParser());
+    conn->timer.owner = fd;
+    conn->lastActivity = TimerWheel::Clock::now();
+    timers_.schedule(conn->timer, kHandshakeTimeout);
+    Connection* raw = conn.get();
+    connections_[fd] = std::move(conn);
+    return raw;
+}
+
+void WebSocketServer::closeConnection(intptr_t clientFd, EventPoller& poller) {
+    auto it = connections_.find(clientFd);
+    if (it == connections_.end()) return;
+    std::unique_ptr<Connection> conn = std::move(it->second);
+    connections_.erase(it);
+    std::string ip = conn->ip;
+    // Сокет ще не закрито, тож id не може дістатися новому з'єднанню
+    if (conn->upgraded && closeCallback_) closeCallback_(clientFd);
+    if (ring_.opened()) {
+        // Ехо close і код помилки — одним записом, як і з epoll. shutdown()
+        // завершує recv, poll і ланцюжок sendmsg у ядрі; сокет закриється
+        // з останнім завершенням (closing_).
+        if (!conn->out.empty() && conn->sendsInFlight == 0) {
+            IoPart parts[kMaxIov];
+            size_t next = 0;
+            int count = gatherFrames(conn->out, next, parts);
+            transportSend(clientFd, nullptr, parts, count, false);
+        }
+        shutdown(static_cast<socket_fd_t>(clientFd), SHUT_RDWR);
+        timers_.cancel(conn->timer);
+        if (conn->ringOps > 0)
+            closing_[clientFd] = std::move(conn);
+        else
+            close_socket(static_cast<socket_fd_t>(clientFd));
+    } else {
+        // Те, що встигло стати в чергу (ехо close, код помилки), відправляємо без очікування
+        if (!conn->out.empty()) flushOutput(*conn, poller);
+        if (conn->tls) conn->tls->shutdown();
+        conn.reset();
+        poller.remove(clientFd);
+        close_socket(static_cast<socket_fd_t>(clientFd));
     }
+    Logger::info("Клієнт відключено: " + ip
+                 + " (активних: " + std::to_string(connections_.size()) + ")");
+}
+
+bool WebSocketServer::doHandshake(Connection& conn) {
+    const http::RequestParser& req = *conn.http;
 
-    std::string acceptKey = computeAcceptKey(key);
-    if (acceptKey.empty()) {
-        Logger::error("Помилка обчислення Accept key");
+    const char* problem = nullptr;
+    if (req.method() != "GET" || req.version() != "HTTP/1.1")
+        problem = "очікувався GET HTTP/1.1";
+    else if (!http::hasToken(req.header("Upgrade"), "websocket"))
+        problem = "немає Upgrade: websocket";
+    else if (!http::hasToken(req.header("Connection"), "upgrade"))
+        problem = "немає Connection: Upgrade";
+    else if (req.header("Sec-WebSocket-Key").empty())
+        problem = "немає Sec-WebSocket-Key";
+    else if (!isValidKey(req.header("Sec-WebSocket-Key")))
+        problem = "Sec-WebSocket-Key не є 16 байтами в base64";
+    if (problem) {
+        Logger::error("Некоректний handshake від " + conn.ip + ": " + problem);
+        static const char kBadRequest[] =
+            "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        sendRaw(conn.fd, conn.tls.get(), kBadRequest, sizeof(kBadRequest) - 1);
+        return false;
+    }
+    if (req.header("Sec-WebSocket-Version") != "13") {
+        Logger::error("Непідтримувана версія WebSocket від " + conn.ip);
+        static const char kUpgradeRequired[] =
+            "HTTP/1.1 426 Upgrade Required\r\nSec-WebSocket-Version: 13\r\n"
+            "Content-Length: 0\r\nConnection: close\r\n\r\n";
+        sendRaw(conn.fd, conn.tls.get(), kUpgradeRequired, sizeof(kUpgradeRequired) - 1);
         return false;
     }
 
-    std::ostringstream resp;
-    resp << "HTTP/1.1 101 Switching Protocols\r\n"
-         << "Upgrade: websocket\r\n"
-         << "Connection: Upgrade\r\n"
-         << "Sec-WebSocket-Accept: " << acceptKey << "\r\n"
-         << "\r\n";
-    std::string response = resp.str();
-#ifdef _WIN32
-    int sent = send(reinterpret_cast<SOCKET>(clientFd), response.data(), static_cast<int>(response.size()), 0);
-#else
-    ssize_t sent = send(static_cast<int>(clientFd), response.data(), response.size(), 0);
-#endif
-    if (sent != static_cast<decltype(sent)>(response.size())) {
+    char acceptKey[kAcceptKeySize];
+    computeAcceptKey(req.header("Sec-WebSocket-Key"), acceptKey);
+
+    ws::DeflateParams deflate;
+    bool compressed = deflatePool_
+        && ws::negotiateDeflate(req.header("Sec-WebSocket-Extensions"), kDeflateConfig, deflate);
+
+    char response[384];
+    FixedWriter w(response, sizeof(response));
+    w << "HTTP/1.1 101 Switching Protocols\r\n"
+      << "Upgrade: websocket\r\n"
+      << "Connection: Upgrade\r\n"
+      << "Sec-WebSocket-Accept: " << std::string_view(acceptKey, sizeof(acceptKey)) << "\r\n";
+    if (compressed) {
+        char ext[128];
+        size_t n = ws::formatDeflateResponse(deflate, ext, sizeof(ext));
+        w << "Sec-WebSocket-Extensions: " << std::string_view(ext, n) << "\r\n";
+    }
+    w << "\r\n";
+    if (!sendRaw(conn.fd, conn.tls.get(), response, w.size)) {
         Logger::error("Помилка відправки handshake");
         return false;
     }
-    Logger::info("WebSocket handshake успішний");
+    if (compressed) {
+        conn.deflate.reset(new ws::DeflateSession(deflate, *deflatePool_, kDeflateConfig.threshold));
+        conn.parser.setCompression(true);
+    }
+    Logger::info(compressed ? "WebSocket handshake успішний (permessage-deflate)" : "WebSocket handshake успішний");
     return true;
 }
 
-void WebSocketServer::handleClient(intptr_t clientFd) {
-    char buffer[kFrameBufSize];
-    while (running_) {
-#ifdef _WIN32
-        int n = recv(reinterpret_cast<SOCKET>(clientFd), buffer, sizeof(buffer), 0);
-#else
-        ssize_t n = recv(static_cast<int>(clientFd), buffer, sizeof(buffer), 0);
-#endif
-        if (n <= 0) break;
+bool WebSocketServer::upgrade(Connection& conn) {
+    if (!doHandshake(conn)) return false;
+    conn.upgraded = true;
+    timers_.schedule(conn.timer, kPingInterval);
 
-        std::string msg = decodeWebSocketFrame(buffer, static_cast<size_t>(n));
-        if (!msg.empty() && messageCallback_) {
-            messageCallback_(msg);
+    // Кадри, що прийшли в тому ж сегменті, що й запит, не губимо
+    std::string_view extra = conn.http->extra();
+    if (!feedFrames(conn, reinterpret_cast<const uint8_t*>(extra.data()), extra.size())) return false;
+    conn.http.reset();
+    return true;
+}
+
+// Байти WebSocket не з recv прямо в розбирач (хвіст HTTP-запиту, наданий
+// буфер io_uring): копіюємо в кільце розбирача частинами й розбираємо
+bool WebSocketServer::feedFrames(Connection& conn, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        size_t chunk = 0;
+        uint8_t* w = conn.parser.input().writePtr(chunk);
+        chunk = std::min(chunk, size);
+        memcpy(w, data, chunk);
+        conn.parser.input().commit(chunk);
+        data += chunk;
+        size -= chunk;
+        if (!decodeWebSocketFrame(conn)) return false;
+    }
+    return true;
+}
+
+// Розбирає отримане і відповідає на всі повні запити в буфері (keep-alive,
+// pipelining), доки не дійде до upgrade, неповного запиту або заблокованої відповіді
+bool WebSocketServer::processRequests(Connection& conn, EventPoller& poller, size_t received) {
+    http::RequestParser::Status status = conn.http->commit(received);
+    for (;;) {
+        switch (status) {
+        case http::RequestParser::Status::NeedMore:
+            return true;
+        case http::RequestParser::Status::Error:
+            Logger::error("Помилка HTTP-запиту від " + conn.ip + ": " + conn.http->errorText());
+            return false;
+        case http::RequestParser::Status::Done:
+            break;
         }
+        if (http::hasToken(conn.http->header("Upgrade"), "websocket")) return upgrade(conn);
+        if (!serveHttp(conn, poller)) return false;
+        if (conn.response) return true;
+        status = conn.http->commit(0);
     }
 }
 
-std::string WebSocketServer::decodeWebSocketFrame(const char* data, size_t len) {
-    if (len < 2) return "";
+// Звичайний HTTP-запит: файл із веб-каталогу, 304 за ETag, 404 або 405
+bool WebSocketServer::serveHttp(Connection& conn, EventPoller& poller) {
+    const http::RequestParser& req = *conn.http;
+    std::unique_ptr<Connection::Response> res(new Connection::Response());
+    res->keepAlive = req.version() == "HTTP/1.1" ? !http::hasToken(req.header("Connection"), "close")
+                                                  : http::hasToken(req.header("Connection"), "keep-alive");
+    bool head = req.method() == "HEAD";
+    // Тіла не читаємо: на тому ж з'єднанні воно розбиралося б як наступний запит
+    if ((!head && req.method() != "GET") || req.hasBody()) res->keepAlive = false;
 
-    const unsigned char* u = reinterpret_cast<const unsigned char*>(data);
-    int opcode = u[0] & 0x0F;
-    bool masked = (u[1] & 0x80) != 0;
-    uint64_t payloadLen = u[1] & 0x7F;
-    size_t headerLen = 2;
+    int status = 200;
+    char path[1024];
+    size_t pathLen = 0;
+    const StaticFileCache::File* file = nullptr;
+    if (!head && req.method() != "GET")
+        status = 405;
+    else if (!files_ || !http::decodePath(req.target(), path, sizeof(path), pathLen)
+             || !(file = files_->find(std::string_view(path, pathLen))))
+        status = 404;
 
-    if (payloadLen == 126) {
-        if (len < 4) return "";
-        payloadLen = (u[2] << 8) | u[3];
-        headerLen = 4;
-    } else if (payloadLen == 127) {
-        if (len < 10) return "";
-        payloadLen = (static_cast<uint64_t>(u[2]) << 56) | (static_cast<uint64_t>(u[3]) << 48)
-                   | (static_cast<uint64_t>(u[4]) << 40) | (static_cast<uint64_t>(u[5]) << 32)
-                   | (u[6] << 24) | (u[7] << 16) | (u[8] << 8) | u[9];
-        headerLen = 10;
+    std::string_view etag;
+    std::string_view body;
+    bool gzip = false;
+    char fileEtag[48];
+    if (file && file->cached) {
+        gzip = !file->gzipBody.empty() && http::acceptsEncoding(req.header("Accept-Encoding"), "gzip");
+        body = gzip ? file->gzipBody : file->body;
+        etag = gzip ? file->gzipEtag : file->etag;
+    } else if (file) {
+        uint64_t size = 0, mtime = 0;
+        res->file = openFile(file->path, size, mtime);
+        if (res->file < 0) {
+            status = 404;
+        } else {
+            res->fileEnd = size;
+            int n = snprintf(fileEtag, sizeof(fileEtag), "\"%llx-%llx\"",
+                             static_cast<unsigned long long>(mtime), static_cast<unsigned long long>(size));
+            etag = std::string_view(fileEtag, static_cast<size_t>(n));
+        }
+    }
+    if (status == 200 && http::etagMatches(req.header("If-None-Match"), etag)) {
+        status = 304;
+        body = std::string_view();
+        res->fileEnd = 0;
     }
 
-    if (opcode != 0x1) return "";
-    if (!masked || len < headerLen + 4 + payloadLen) return "";
+    FixedWriter w(res->head, sizeof(res->head));
+    switch (status) {
+    case 200:
+        w << "HTTP/1.1 200 OK\r\nContent-Type: " << file->contentType
+          << "\r\nContent-Length: " << static_cast<uint64_t>(res->file >= 0 ? res->fileEnd : body.size());
+        if (gzip) w << "\r\nContent-Encoding: gzip";
+        break;
+    case 304:
+        w << "HTTP/1.1 304 Not Modified";
+        break;
+    case 404:
+        body = "Not Found\n";
+        w << "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain; charset=utf-8\r\nContent-Length: "
+          << static_cast<uint64_t>(body.size());
+        break;
+    default:
+        body = "Method Not Allowed\n";
+        w << "HTTP/1.1 405 Method Not Allowed\r\nAllow: GET, HEAD\r\nContent-Type: text/plain; charset=utf-8"
+          << "\r\nContent-Length: " << static_cast<uint64_t>(body.size());
+        break;
+    }
+    if (status == 200 || status == 304) {
+        w << "\r\nETag: " << etag << "\r\nCache-Control: no-cache";
+        if (!file->gzipBody.empty()) w << "\r\nVary: Accept-Encoding";
+    }
+    w << (res->keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n");
+    res->headSize = w.size;
+    if (head) {
+        body = std::string_view();
+        res->fileEnd = 0;
+    }
+    res->body = body;
+
+    Logger::info("HTTP " + std::string(req.method()) + " " + std::string(req.target()) + " "
+                 + std::to_string(status) + " (" + conn.ip + ")");
+    conn.response = std::move(res);
+    return writeResponse(conn, poller);
+}
+
+// Відправляє поточну відповідь, доки сокет приймає. Після повної відправки
+// з'єднання або закривається (false), або готове до наступного запиту.
+bool WebSocketServer::writeResponse(Connection& conn, EventPoller& poller) {
+    Connection::Response& res = *conn.response;
+    for (;;) {
+        size_t total = res.headSize + res.body.size();
+        long long n;
+        if (res.offset < total) {
+            const char* chunks[2] = {res.head, res.body.data()};
+            size_t sizes[2] = {res.headSize, res.body.size()};
+            IoPart parts[2];
+            int count = 0;
+            size_t skip = res.offset;
+            for (int c = 0; c < 2; c++) {
+                size_t off = std::min(skip, sizes[c]);
+                skip -= off;
+                if (off == sizes[c]) continue;
+                setPart(parts[count++], chunks[c] + off, sizes[c] - off);
+            }
+            // Заголовки й початок файлу підуть одним сегментом
+            n = transportSend(conn.fd, conn.tls.get(), parts, count, res.fileOffset < res.fileEnd);
+        } else if (res.fileOffset < res.fileEnd) {
+            size_t count = static_cast<size_t>(std::min<uint64_t>(res.fileEnd - res.fileOffset, kFileChunk));
+            n = transportSendFile(conn.fd, conn.tls.get(), res.file, res.fileOffset, count);
+            if (n == 0) {
+                Logger::error("Файл змінився під час відправки (" + conn.ip + ")");
+                return false;
+            }
+        } else {
+            break;
+        }
+
+        if (n == tls::kFailed) return false;
+        if (n == tls::kWouldBlock) {
+            if (ring_.opened()) {
+                // Одноразовий poll: ставиться після кожного EAGAIN
+                res.blocked = true;
+                if (!ring_.poll(conn.fd, POLLOUT, false, ringData(RingWritable, conn.fd))) return false;
+                conn.ringOps++;
+                return true;
+            }
+            if (!res.blocked) {
+                res.blocked = true;
+                poller.modify(conn.fd, EventPoller::Writable);
+            }
+            return true;
+        }
+        conn.lastActivity = TimerWheel::Clock::now();
+        if (res.offset < total)
+            res.offset += static_cast<size_t>(n);
+        else
+            res.fileOffset += static_cast<uint64_t>(n);
+    }
+
+    bool keepAlive = res.keepAlive;
+    bool blocked = res.blocked;
+    conn.response.reset();
+    if (!keepAlive) return false;
+    if (blocked && !ring_.opened()) poller.modify(conn.fd, EventPoller::Readable);
+    conn.http->reset();
+    timers_.schedule(conn.timer, kHandshakeTimeout);
+    return true;
+}
+
+// Writable під час HTTP-відповіді: дописуємо її, потім беремося за запити,
+// що вже чекають у буфері та в сокеті (epoll edge-triggered сам не нагадає)
+bool WebSocketServer::resumeResponse(Connection& conn, EventPoller& poller) {
+    if (!writeResponse(conn, poller)) return false;
+    if (conn.response) return true;
+    return processRequests(conn, poller, 0) && handleClient(conn, poller);
+}
 
-    const unsigned char* mask = u + headerLen;
-    std::string result;
-    result.reserve(payloadLen);
-    for (size_t i = 0; i < payloadLen; i++)
-        result += static_cast<char>(u[headerLen + 4 + i] ^ mask[i % 4]);
-    return result;
+// Крок TLS handshake; true — з'єднання живе (можливо, handshake ще триває)
+bool WebSocketServer::tlsHandshake(Connection& conn, EventPoller& poller) {
+    switch (conn.tls->handshake()) {
+    case tls::Session::Handshake::Done:
+        Logger::info("TLS: " + conn.tls->describe() + (conn.tls->resumed() ? ", відновлена сесія" : "")
+                     + (conn.tls->kernelSend() ? ", kTLS" : "") + " (" + conn.ip + ")");
+        return true;
+    case tls::Session::Handshake::WantRead:
+        return true;
+    case tls::Session::Handshake::WantWrite:
+        waitTlsWritable(conn, poller);
+        return true;
+    case tls::Session::Handshake::Failed:
+        break;
+    }
+    Logger::error("Помилка TLS handshake з " + conn.ip + ": " + conn.tls->error());
+    return false;
+}
+
+// Читання TLS уперлося в повний буфер сокета (handshake, квитки сесії):
+// продовжимо на Writable
+void WebSocketServer::waitTlsWritable(Connection& conn, EventPoller& poller) {
+    if (conn.tlsWantsWrite) return;
+    conn.tlsWantsWrite = true;
+    if (!conn.writeBlocked) poller.modify(conn.fd, EventPoller::Readable | EventPoller::Writable);
+}
+
+// io_uring: до upgrade — одноразовий recv прямо в буфер HTTP-запиту (поки
+// відповідь не пішла, нових запитів не читаємо), після — multishot recv у
+// надані буфери, що лишається активним, доки є дані
+bool WebSocketServer::armRecv(Connection& conn) {
+    if (conn.recvArmed || (!conn.upgraded && conn.response)) return true;
+    bool ok;
+    if (conn.upgraded) {
+        ok = ring_.recvMultishot(conn.fd, ringData(RingRecv, conn.fd));
+    } else {
+        size_t room = 0;
+        char* dst = conn.http->writePtr(room);
+        if (room == 0) {
+            Logger::error("Завеликий HTTP-запит від " + conn.ip);
+            return false;
+        }
+        ok = ring_.recv(conn.fd, dst, room, ringData(RingRecv, conn.fd));
+    }
+    if (!ok) return false;
+    conn.recvArmed = true;
+    conn.ringOps++;
+    return true;
+}
+
+bool WebSocketServer::handleClient(Connection& conn, EventPoller& poller) {
+    // io_uring читає сам: лише переконуємося, що recv стоїть у черзі
+    if (ring_.opened()) return armRecv(conn);
+    if (conn.tls && !conn.tls->established()) {
+        if (!tlsHandshake(conn, poller)) return false;
+        if (!conn.tls->established()) return true;
+    }
+    for (;;) {
+        char* dst;
+        size_t room;
+        if (conn.upgraded) {
+            // Після handshake читаємо одразу в кільцевий буфер розбирача
+            dst = reinterpret_cast<char*>(conn.parser.input().writePtr(room));
+            if (room == 0) {
+                if (!decodeWebSocketFrame(conn)) return false;
+                continue;
+            }
+        } else {
+            if (conn.response) return true;
+            dst = conn.http->writePtr(room);
+            if (room == 0) {
+                Logger::error("Завеликий HTTP-запит від " + conn.ip);
+                return false;
+            }
+        }
+        long long n = transportRecv(conn.fd, conn.tls.get(), dst, room);
+        if (n == 0 || n == tls::kFailed) return false;
+        if (n == tls::kWouldBlock) {
+            if (conn.tls && conn.tls->wantsWrite()) waitTlsWritable(conn, poller);
+            return true;
+        }
+        conn.lastActivity = TimerWheel::Clock::now();
+
+        if (conn.upgraded) {
+            conn.parser.input().commit(static_cast<size_t>(n));
+            if (!decodeWebSocketFrame(conn)) return false;
+            continue;
+        }
+        if (!processRequests(conn, poller, static_cast<size_t>(n))) return false;
+    }
+}
+
+bool WebSocketServer::decodeWebSocketFrame(Connection& conn) {
+    ws::FrameParser::Message msg;
+    for (;;) {
+        switch (conn.parser.next(msg)) {
+        case ws::FrameParser::Status::NeedMore:
+            return true;
+        case ws::FrameParser::Status::Error:
+            Logger::error("Помилка протоколу від " + conn.ip + ": " + conn.parser.errorText());
+            queueFrame(conn, closeFrame(conn.parser.errorCode()));
+            return false;
+        case ws::FrameParser::Status::Control:
+            if (msg.opcode == ws::OpPing) {
+                queueFrame(conn, ws::makeFrame(ws::OpPong, msg.data, msg.size));
+            } else if (msg.opcode == ws::OpClose) {
+                // Відповідаємо тим самим кодом (парсер пропускає лише допустимі)
+                // або порожнім close і закриваємо (RFC 6455 §5.5.1)
+                uint16_t code = msg.size >= 2 ? static_cast<uint16_t>((msg.data[0] << 8) | msg.data[1]) : 0;
+                queueFrame(conn, closeFrame(code));
+                return false;
+            }
+            break;
+        case ws::FrameParser::Status::Message: {
+            if (msg.compressed) {
+                size_t n = 0;
+                ws::DeflateSession::InflateResult r = conn.deflate->decompress(
+                    msg.data, msg.size, inflateBuf_.get(), ws::FrameParser::kDefaultMaxMessageSize, n);
+                if (r != ws::DeflateSession::InflateResult::Ok) {
+                    bool tooBig = r == ws::DeflateSession::InflateResult::TooBig;
+                    Logger::error("Помилка розпакування від " + conn.ip
+                                  + (tooBig ? ": повідомлення перевищує ліміт" : ": пошкоджені дані"));
+                    queueFrame(conn, closeFrame(tooBig ? 1009 : 1007));
+                    return false;
+                }
+                msg.data = inflateBuf_.get();
+                msg.size = n;
+            }
+            if (msg.size == 0) break;
+            latency::Timing& timing = latency::current();
+            timing.readable = conn.readableAt;
+            timing.decoded = latency::now();
+            currentConnection_ = conn.fd;
+            if (msg.opcode == ws::OpText && messageCallback_)
+                messageCallback_(std::string(reinterpret_cast<const char*>(msg.data), msg.size));
+            else if (msg.opcode == ws::OpBinary && binaryCallback_)
+                binaryCallback_(msg.data, msg.size);
+            currentConnection_ = kNoConnection;
+            timing = latency::Timing();
+            break;
+        }
+        }
+    }
 }
@@ -1,14 +1,42 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <functional>
 #include <thread>
 #include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "io_ring.h"
+#include "timer_wheel.h"
+
+class EventPoller;
+class StaticFileCache;
+
+namespace ws {
+struct OutFrame;
+class DeflatePool;
+}
+
+namespace tls {
+class Context;
+}
 
 class WebSocketServer {
 public:
     using MessageCallback = std::function<void(const std::string&)>;
+    // Бінарне повідомлення (opcode 0x2); дані дійсні лише під час виклику
+    using BinaryCallback = std::function<void(const uint8_t* data, size_t size)>;
+    // Ідентифікатор з'єднання (дескриптор сокета)
+    using ConnectionId = intptr_t;
+    static const ConnectionId kNoConnection = -1;
+    // З'єднання після upgrade закрито: клієнт пішов, помилка, тайм-аут
+    // простою або зупинка сервера. Викликається в мережевому потоці.
+    using CloseCallback = std::function<void(ConnectionId id)>;
 
     explicit WebSocketServer(uint16_t port = 8765);
     ~WebSocketServer();
@@ -17,18 +45,124 @@ public:
     void stop();
 
     void setMessageCallback(MessageCallback callback);
+    void setBinaryCallback(BinaryCallback callback);
+    void setCloseCallback(CloseCallback callback);
+
+    // Звичайні HTTP GET/HEAD на тому ж порту віддаються з цього каталогу.
+    // Вміст читається в пам'ять одразу; викликати до start(). false — каталог недоступний.
+    bool setWebRoot(const std::string& dir);
+
+    // permessage-deflate (RFC 7692) для клієнтів, що його пропонують; увімкнено
+    // за замовчуванням, якщо зібрано з zlib. Викликати до start().
+    void setCompression(bool enabled) { compression_ = enabled; }
+
+    // wss:// і https:// замість відкритого тексту на тому ж порту. Сертифікат
+    // і ключ у PEM; викликати до start(). false — файли не підходять або
+    // сервер зібрано без OpenSSL.
+    bool setTls(const std::string& certFile, const std::string& keyFile);
+
+    // io_uring замість epoll (Linux 6.1+, лише без TLS); якщо ядро його не
+    // дає, сервер сам лишається на epoll. Викликати до start().
+    void setIoUring(bool enabled) { ioUring_ = enabled; }
+
+    // Шард: кілька серверів слухають той самий порт (SO_REUSEPORT, нові
+    // з'єднання ядро розподіляє між ними), у кожного свій потік, цикл подій
+    // і таблиця з'єднань. cpu — закріпити потік за цим CPU (-1 — ні).
+    // Викликати до start().
+    void setReusePort(bool enabled) { reusePort_ = enabled; }
+    void setCpu(int cpu) { cpu_ = cpu; }
+    // Квитки TLS, видані from, приймаються й тут; після setTls() в обох
+    bool shareTlsTickets(const WebSocketServer& from);
 
     bool isRunning() const { return running_; }
 
+    // Надсилання кадрів. Можна викликати з будь-якого потоку: кадр ставиться
+    // в обмежену чергу з'єднання і відправляється мережевим потоком.
+    // false — з'єднання немає, сервер не запущено або черга з'єднання переповнена
+    // (з чужого потоку про це дізнатися не можна, помилка лише логується).
+    bool sendText(ConnectionId id, const std::string& text);
+    bool sendBinary(ConnectionId id, const uint8_t* data, size_t size);
+    // Кадр кодується один раз і ділиться між чергами всіх з'єднань
+    void broadcastText(const std::string& text);
+    void broadcastBinary(const uint8_t* data, size_t size);
+
+    // З'єднання, повідомлення якого зараз обробляє колбек (лише з колбека)
+    ConnectionId messageConnection() const { return currentConnection_; }
+
+    // Sec-WebSocket-Accept: base64 від SHA1 (20 байтів) — завжди 28 символів
+    static const size_t kAcceptKeySize = 28;
+    static void computeAcceptKey(std::string_view key, char out[kAcceptKeySize]);
+
 private:
+    struct Connection;
+    using FramePtr = std::shared_ptr<const ws::OutFrame>;
+
     void run();
-    bool doHandshake(intptr_t clientFd);
-    void handleClient(intptr_t clientFd);
-    std::string decodeWebSocketFrame(const char* data, size_t len);
-    static std::string computeAcceptKey(const std::string& key);
+    void pollLoop(intptr_t listenFd, EventPoller& poller);
+    void ringLoop(intptr_t listenFd, EventPoller& poller);
+    void onRingCompletion(const IoRing::Completion& c, intptr_t listenFd, EventPoller& poller, uint64_t readableAt);
+    void acceptClients(intptr_t listenFd, EventPoller& poller);
+    void pauseAccept(intptr_t listenFd, EventPoller& poller, int err);
+    void resumeAccept(intptr_t listenFd, EventPoller& poller);
+    Connection* addClient(intptr_t fd, const char* ip);
+    void closeConnection(intptr_t clientFd, EventPoller& poller);
+    bool doHandshake(Connection& conn);
+    bool upgrade(Connection& conn);
+    bool handleClient(Connection& conn, EventPoller& poller);
+    bool tlsHandshake(Connection& conn, EventPoller& poller);
+    void waitTlsWritable(Connection& conn, EventPoller& poller);
+    bool processRequests(Connection& conn, EventPoller& poller, size_t received);
+    bool serveHttp(Connection& conn, EventPoller& poller);
+    bool writeResponse(Connection& conn, EventPoller& poller);
+    bool resumeResponse(Connection& conn, EventPoller& poller);
+    bool decodeWebSocketFrame(Connection& conn);
+    bool sendFrame(ConnectionId id, FramePtr frame);
+    bool queueFrame(Connection& conn, const FramePtr& frame);
+    bool flushOutput(Connection& conn, EventPoller& poller);
+    bool feedFrames(Connection& conn, const uint8_t* data, size_t size);
+    bool armRecv(Connection& conn);
+    bool submitOutput(Connection& conn);
+    bool onRingSent(Connection& conn, int32_t result);
+    void flushPending(EventPoller& poller);
+    void onTimer(intptr_t clientFd, EventPoller& poller);
 
     uint16_t port_;
     MessageCallback messageCallback_;
+    BinaryCallback binaryCallback_;
+    CloseCallback closeCallback_;
+    std::unique_ptr<StaticFileCache> files_;
+    bool compression_ = true;
+    std::unique_ptr<tls::Context> tls_;
+    bool ioUring_ = true;
+    bool reusePort_ = false;
+    int cpu_ = -1;
     std::thread workerThread_;
     std::atomic<bool> running_;
+    // Таймери з'єднань (handshake, ping, простій); оголошено до connections_,
+    // щоб з'єднання знищувалися раніше за колесо
+    TimerWheel timers_;
+    // accept відкладено після стійкої помилки (EMFILE тощо): таймер повертає
+    // сокет прослуховування; acceptError_ — помилка поточного епізоду, 0 — немає
+    TimerWheel::Timer acceptTimer_;
+    int acceptError_ = 0;
+    // Потоки zlib, спільні для всіх з'єднань; сесії з'єднань повертають їх сюди,
+    // тож пул має пережити connections_
+    std::unique_ptr<ws::DeflatePool> deflatePool_;
+    std::unique_ptr<uint8_t[]> inflateBuf_; // розпаковане повідомлення, лише мережевий потік
+    std::unordered_map<intptr_t, std::unique_ptr<Connection>> connections_;
+    // io_uring: закриті з'єднання, на які ще посилаються операції в ядрі.
+    // Сокет закривається, коли завершиться остання, тож номер не використається
+    // повторно, поки ядро може повернути завершення зі старим.
+    std::unordered_map<intptr_t, std::unique_ptr<Connection>> closing_;
+    IoRing ring_; // відкрите лише під час run() з io_uring
+    ConnectionId currentConnection_ = kNoConnection;
+
+    // Стан лише мережевого потоку: з'єднання з новими кадрами в черзі
+    std::vector<intptr_t> dirty_;
+    std::atomic<std::thread::id> networkThread_;
+
+    // Кадри від інших потоків; kNoConnection — broadcast
+    std::mutex outboxMutex_;
+    std::vector<std::pair<ConnectionId, FramePtr>> outbox_;
+    EventPoller* poller_ = nullptr; // під outboxMutex_, лише для wake()
 };
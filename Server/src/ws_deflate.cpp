@@ -0,0 +1,295 @@
+#include "ws_deflate.h"
+#include "http_parser.h"
+#include <algorithm>
+#include <cstdio>
+
+#ifdef REMOTECONTROL_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ws {
+
+namespace {
+
+#ifdef REMOTECONTROL_HAVE_ZLIB
+const bool kHaveZlib = true;
+#else
+const bool kHaveZlib = false;
+#endif
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// Значення *_max_window_bits: 8..15, можливо в лапках (RFC 7692 §7.1)
+bool parseWindowBits(std::string_view v, int& bits) {
+    if (v.size() >= 2 && v.front() == '"' && v.back() == '"') v = v.substr(1, v.size() - 2);
+    if (v.empty() || v.size() > 2) return false;
+    int n = 0;
+    for (char c : v) {
+        if (c < '0' || c > '9') return false;
+        n = n * 10 + (c - '0');
+    }
+    if (n < 8 || n > 15) return false;
+    bits = n;
+    return true;
+}
+
+// Одна пропозиція: "permessage-deflate; param; param=value"
+bool acceptOffer(std::string_view offer, const DeflateConfig& config, DeflateParams& p) {
+    size_t semi = offer.find(';');
+    if (!http::equalsIgnoreCase(trim(offer.substr(0, semi)), "permessage-deflate")) return false;
+
+    p = DeflateParams();
+    int serverBits = 0;   // 0 — не пропонувалося
+    int clientBits = 0;
+    bool seen[4] = {false, false, false, false};
+    while (semi != std::string_view::npos) {
+        offer.remove_prefix(semi + 1);
+        semi = offer.find(';');
+        std::string_view param = trim(offer.substr(0, semi));
+        size_t eq = param.find('=');
+        std::string_view name = trim(param.substr(0, eq));
+        std::string_view value = eq == std::string_view::npos ? std::string_view() : trim(param.substr(eq + 1));
+        bool hasValue = eq != std::string_view::npos;
+
+        int index;
+        if (name == "server_no_context_takeover") {
+            index = 0;
+            if (hasValue) return false;
+            p.serverNoContextTakeover = true;
+        } else if (name == "client_no_context_takeover") {
+            index = 1;
+            if (hasValue) return false;
+            p.clientNoContextTakeover = true;
+        } else if (name == "server_max_window_bits") {
+            index = 2;
+            if (!parseWindowBits(value, serverBits)) return false;
+        } else if (name == "client_max_window_bits") {
+            index = 3;
+            clientBits = 15;
+            if (hasValue && !parseWindowBits(value, clientBits)) return false;
+        } else {
+            return false;
+        }
+        // Повтор параметра робить пропозицію некоректною (§7)
+        if (seen[index]) return false;
+        seen[index] = true;
+    }
+
+    p.serverMaxWindowBits = std::min(config.serverMaxWindowBits, serverBits ? serverBits : 15);
+    // zlib не вміє raw deflate з вікном 256 байтів; більше вікно клієнт не розпакує
+    if (p.serverMaxWindowBits < 9) return false;
+    p.serverBitsInResponse = serverBits != 0;
+
+    // Обмежити вікно клієнта можна, лише якщо він сам це запропонував
+    if (clientBits) {
+        p.clientMaxWindowBits = std::min(config.clientMaxWindowBits, clientBits);
+        p.clientBitsInResponse = true;
+    }
+    if (config.clientNoContextTakeover) p.clientNoContextTakeover = true;
+    return true;
+}
+
+} // namespace
+
+bool negotiateDeflate(std::string_view extensions, const DeflateConfig& config, DeflateParams& params) {
+    if (!kHaveZlib) return false;
+    while (!extensions.empty()) {
+        size_t comma = extensions.find(',');
+        if (acceptOffer(trim(extensions.substr(0, comma)), config, params)) return true;
+        if (comma == std::string_view::npos) break;
+        extensions.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+size_t formatDeflateResponse(const DeflateParams& params, char* out, size_t capacity) {
+    int n = snprintf(out, capacity, "permessage-deflate%s%s",
+                     params.serverNoContextTakeover ? "; server_no_context_takeover" : "",
+                     params.clientNoContextTakeover ? "; client_no_context_takeover" : "");
+    if (params.serverBitsInResponse && n >= 0 && static_cast<size_t>(n) < capacity)
+        n += snprintf(out + n, capacity - n, "; server_max_window_bits=%d", params.serverMaxWindowBits);
+    if (params.clientBitsInResponse && n >= 0 && static_cast<size_t>(n) < capacity)
+        n += snprintf(out + n, capacity - n, "; client_max_window_bits=%d", params.clientMaxWindowBits);
+    if (n < 0) return 0;
+    return std::min(static_cast<size_t>(n), capacity - 1);
+}
+
+#ifdef REMOTECONTROL_HAVE_ZLIB
+
+struct DeflatePool::Stream {
+    z_stream z;
+    bool deflate;
+    int windowBits;
+};
+
+DeflatePool::DeflatePool(int level, int memLevel) : level_(level), memLevel_(memLevel) {}
+
+DeflatePool::~DeflatePool() {
+    for (Stream* s : idle_) {
+        if (s->deflate) deflateEnd(&s->z);
+        else inflateEnd(&s->z);
+        delete s;
+    }
+}
+
+DeflatePool::Stream* DeflatePool::acquire(bool deflate, int windowBits) {
+    for (size_t i = 0; i < idle_.size(); i++) {
+        Stream* s = idle_[i];
+        if (s->deflate == deflate && s->windowBits == windowBits) {
+            idle_[i] = idle_.back();
+            idle_.pop_back();
+            return s;
+        }
+    }
+    Stream* s = new Stream();
+    s->deflate = deflate;
+    s->windowBits = windowBits;
+    // Від'ємні windowBits — "сирий" deflate без заголовка zlib, як вимагає RFC 7692
+    int rc = deflate ? deflateInit2(&s->z, level_, Z_DEFLATED, -windowBits, memLevel_, Z_DEFAULT_STRATEGY)
+                     : inflateInit2(&s->z, -windowBits);
+    if (rc != Z_OK) {
+        delete s;
+        return nullptr;
+    }
+    return s;
+}
+
+void DeflatePool::release(Stream* stream) {
+    if (idle_.size() < kMaxIdle) {
+        if (stream->deflate) deflateReset(&stream->z);
+        else inflateReset(&stream->z);
+        idle_.push_back(stream);
+        return;
+    }
+    if (stream->deflate) deflateEnd(&stream->z);
+    else inflateEnd(&stream->z);
+    delete stream;
+}
+
+#else
+
+struct DeflatePool::Stream {};
+
+DeflatePool::DeflatePool(int level, int memLevel) : level_(level), memLevel_(memLevel) {}
+
+DeflatePool::~DeflatePool() {}
+
+DeflatePool::Stream* DeflatePool::acquire(bool, int) {
+    return nullptr;
+}
+
+void DeflatePool::release(Stream* stream) {
+    delete stream;
+}
+
+#endif
+
+size_t DeflatePool::idleCount() const {
+    return idle_.size();
+}
+
+DeflateSession::DeflateSession(const DeflateParams& params, DeflatePool& pool, size_t threshold)
+    : params_(params), pool_(pool), threshold_(threshold) {}
+
+DeflateSession::~DeflateSession() {
+    if (deflater_) pool_.release(deflater_);
+    if (inflater_) pool_.release(inflater_);
+}
+
+#ifdef REMOTECONTROL_HAVE_ZLIB
+
+bool DeflateSession::compress(const void* data, size_t size, std::string& out) {
+    if (!deflater_) deflater_ = pool_.acquire(true, params_.serverMaxWindowBits);
+    if (!deflater_) return false;
+    z_stream& z = deflater_->z;
+
+    // Місця рівно на "не більше оригіналу" плюс хвіст 00 00 ff ff, що відрізається:
+    // якщо не влізло, стиснення не виграє
+    out.resize(size + 4);
+    z.next_in = static_cast<Bytef*>(const_cast<void*>(data));
+    z.avail_in = static_cast<uInt>(size);
+    z.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    z.avail_out = static_cast<uInt>(out.size());
+    int rc = deflate(&z, Z_SYNC_FLUSH);
+    size_t produced = out.size() - z.avail_out;
+    bool ok = rc == Z_OK && z.avail_in == 0 && z.avail_out > 0 && produced > 4 && produced - 4 < size;
+
+    if (!ok || params_.serverNoContextTakeover) {
+        pool_.release(deflater_);  // скидає контекст; клієнт про нього не знатиме
+        deflater_ = nullptr;
+    }
+    if (!ok) return false;
+    out.resize(produced - 4);
+    return true;
+}
+
+DeflateSession::InflateResult DeflateSession::decompress(const uint8_t* data, size_t size, uint8_t* out,
+                                                         size_t capacity, size_t& outLen) {
+    static const uint8_t kTail[4] = {0x00, 0x00, 0xff, 0xff};
+    outLen = 0;
+    if (!inflater_) inflater_ = pool_.acquire(false, params_.clientMaxWindowBits);
+    if (!inflater_) return InflateResult::Corrupt;
+    z_stream& z = inflater_->z;
+
+    z.next_out = out;
+    z.avail_out = static_cast<uInt>(capacity);
+    InflateResult result = InflateResult::Ok;
+    const uint8_t* parts[2] = {data, kTail};
+    size_t sizes[2] = {size, sizeof(kTail)};
+    bool ended = false;
+    for (int i = 0; i < 2 && !ended && result == InflateResult::Ok; i++) {
+        z.next_in = const_cast<Bytef*>(parts[i]);
+        z.avail_in = static_cast<uInt>(sizes[i]);
+        while (z.avail_in > 0) {
+            int rc = inflate(&z, Z_SYNC_FLUSH);
+            if (rc == Z_STREAM_END) {
+                // Клієнт закрив потік (BFINAL): наступне повідомлення почнеться з нового
+                ended = true;
+                break;
+            }
+            if (rc == Z_BUF_ERROR && z.avail_out == 0) {
+                result = InflateResult::TooBig;
+                break;
+            }
+            if (rc != Z_OK) {
+                result = InflateResult::Corrupt;
+                break;
+            }
+        }
+    }
+    // Буфер заповнено впритул: перевіряємо, чи не лишилося ще даних
+    if (result == InflateResult::Ok && !ended && z.avail_out == 0) {
+        uint8_t probe;
+        z.next_out = &probe;
+        z.avail_out = 1;
+        int rc = inflate(&z, Z_SYNC_FLUSH);
+        if ((rc == Z_OK || rc == Z_STREAM_END) && z.avail_out == 0) result = InflateResult::TooBig;
+        z.avail_out = 0;
+    }
+    outLen = capacity - z.avail_out;
+
+    if (ended || result != InflateResult::Ok || params_.clientNoContextTakeover) {
+        pool_.release(inflater_);
+        inflater_ = nullptr;
+    }
+    return result;
+}
+
+#else
+
+bool DeflateSession::compress(const void*, size_t, std::string&) {
+    return false;
+}
+
+DeflateSession::InflateResult DeflateSession::decompress(const uint8_t*, size_t, uint8_t*, size_t, size_t& outLen) {
+    outLen = 0;
+    return InflateResult::Corrupt;
+}
+
+#endif
+
+} // namespace ws
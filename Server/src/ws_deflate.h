@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ws {
+
+// Розширення permessage-deflate (RFC 7692). Без zlib (REMOTECONTROL_HAVE_ZLIB)
+// узгодження завжди відхиляється і з'єднання працюють без стиснення.
+
+struct DeflateConfig {
+    // Вікна LZ77: пам'ять потоку стиснення ~ 2^(bits+2) + 2^(memLevel+9),
+    // розпакування ~ 2^bits + 7 KiB
+    int serverMaxWindowBits = 13;
+    int clientMaxWindowBits = 13;  // просимо клієнта, якщо він дозволяє обмеження
+    int memLevel = 7;
+    int level = 6;
+    // Команди від клієнта короткі: без спільного контексту потік розпакування
+    // повертається в пул одразу після повідомлення
+    bool clientNoContextTakeover = true;
+    size_t threshold = 128;        // коротші повідомлення не стискаються
+};
+
+// Параметри, узгоджені для одного з'єднання
+struct DeflateParams {
+    bool serverNoContextTakeover = false;
+    bool clientNoContextTakeover = false;
+    int serverMaxWindowBits = 15;
+    int clientMaxWindowBits = 15;
+    bool serverBitsInResponse = false;
+    bool clientBitsInResponse = false;
+};
+
+// Обирає першу прийнятну пропозицію permessage-deflate із Sec-WebSocket-Extensions.
+// false — розширення не пропонувалося, жодна пропозиція не підходить або zlib недоступний.
+bool negotiateDeflate(std::string_view extensions, const DeflateConfig& config, DeflateParams& params);
+
+// Значення Sec-WebSocket-Extensions для відповіді; повертає довжину
+size_t formatDeflateResponse(const DeflateParams& params, char* out, size_t capacity);
+
+// Потоки zlib, що переходять між з'єднаннями і повідомленнями замість
+// deflateInit/deflateEnd щоразу. Лише мережевий потік.
+class DeflatePool {
+public:
+    struct Stream;
+
+    DeflatePool(int level, int memLevel);
+    ~DeflatePool();
+
+    DeflatePool(const DeflatePool&) = delete;
+    DeflatePool& operator=(const DeflatePool&) = delete;
+
+    // nullptr — zlib не зміг виділити пам'ять
+    Stream* acquire(bool deflate, int windowBits);
+    // Потік скидається і лишається в пулі (усього не більше kMaxIdle)
+    void release(Stream* stream);
+
+    size_t idleCount() const;
+
+    static const size_t kMaxIdle = 8;
+
+private:
+    int level_;
+    int memLevel_;
+    std::vector<Stream*> idle_;
+};
+
+// Стан permessage-deflate одного з'єднання. Потоки беруться з пулу при
+// першому повідомленні; без context takeover повертаються одразу після нього.
+class DeflateSession {
+public:
+    enum class InflateResult {
+        Ok,
+        TooBig,   // розпаковане більше за capacity
+        Corrupt   // пошкоджені дані
+    };
+
+    DeflateSession(const DeflateParams& params, DeflatePool& pool, size_t threshold);
+    ~DeflateSession();
+
+    DeflateSession(const DeflateSession&) = delete;
+    DeflateSession& operator=(const DeflateSession&) = delete;
+
+    bool shouldCompress(size_t size) const { return size >= threshold_; }
+
+    // Стиснутий payload (без хвоста 00 00 ff ff) в out. false — стиснення
+    // не зменшило дані або zlib повернув помилку: повідомлення треба відправити
+    // як є, контекст уже скинуто.
+    bool compress(const void* data, size_t size, std::string& out);
+
+    InflateResult decompress(const uint8_t* data, size_t size, uint8_t* out, size_t capacity, size_t& outLen);
+
+    const DeflateParams& params() const { return params_; }
+
+private:
+    DeflateParams params_;
+    DeflatePool& pool_;
+    size_t threshold_;
+    DeflatePool::Stream* deflater_ = nullptr;
+    DeflatePool::Stream* inflater_ = nullptr;
+};
+
+} // namespace ws
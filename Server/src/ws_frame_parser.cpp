@@ -0,0 +1,171 @@
+#include "ws_frame_parser.h"
+#include "ws_unmask.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ws {
+
+namespace {
+
+// RFC 6455 §7.4: 1004-1006 і 1015 зарезервовано — у кадрі їх бути не може,
+// 1016-2999 ще не визначено, 3000-4999 — для бібліотек і застосунків
+bool isValidCloseCode(uint16_t code) {
+    if (code < 1000 || code >= 5000) return false;
+    if (code >= 1004 && code <= 1006) return false;
+    return code <= 1014 || code >= 3000;
+}
+
+} // namespace
+
+RingBuffer::RingBuffer(size_t capacity) {
+    size_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+    buf_.reset(new uint8_t[cap]);
+    mask_ = cap - 1;
+}
+
+uint8_t* RingBuffer::writePtr(size_t& contiguous) {
+    size_t pos = static_cast<size_t>(tail_) & mask_;
+    contiguous = std::min(capacity() - size(), capacity() - pos);
+    return buf_.get() + pos;
+}
+
+const uint8_t* RingBuffer::readPtr(size_t& contiguous) const {
+    size_t pos = static_cast<size_t>(head_) & mask_;
+    contiguous = std::min(size(), capacity() - pos);
+    return buf_.get() + pos;
+}
+
+void RingBuffer::copyOut(uint8_t* dst, size_t n) const {
+    size_t pos = static_cast<size_t>(head_) & mask_;
+    size_t first = std::min(n, capacity() - pos);
+    std::memcpy(dst, buf_.get() + pos, first);
+    std::memcpy(dst + first, buf_.get(), n - first);
+}
+
+FrameParser::FrameParser(size_t inputSize, size_t maxMessageSize)
+    : input_(inputSize),
+      message_(new uint8_t[maxMessageSize]),
+      maxMessageSize_(maxMessageSize) {}
+
+FrameParser::Status FrameParser::fail(uint16_t code, const char* text) {
+    errorCode_ = code;
+    errorText_ = text;
+    return Status::Error;
+}
+
+// Розбирає заголовок, якщо він уже повністю в буфері. Нічого не споживає інакше.
+bool FrameParser::parseHeader() {
+    size_t avail = input_.size();
+    if (avail < 2) return false;
+
+    uint8_t b0 = input_.peek(0);
+    uint8_t b1 = input_.peek(1);
+    size_t headerLen = 2;
+    uint64_t len = b1 & 0x7F;
+    if (len == 126) headerLen += 2;
+    else if (len == 127) headerLen += 8;
+    bool masked = (b1 & 0x80) != 0;
+    if (masked) headerLen += 4;
+    if (avail < headerLen) return false;
+
+    uint8_t hdr[14];
+    input_.copyOut(hdr, headerLen);
+    size_t off = 2;
+    if (len == 126) {
+        len = (static_cast<uint64_t>(hdr[2]) << 8) | hdr[3];
+        off = 4;
+    } else if (len == 127) {
+        len = 0;
+        for (int i = 0; i < 8; i++)
+            len = (len << 8) | hdr[2 + i];
+        off = 10;
+    }
+    if (masked) std::memcpy(mask_, hdr + off, 4);
+    else std::memset(mask_, 0, 4);
+
+    input_.consume(headerLen);
+    inFrame_ = true;
+    fin_ = (b0 & 0x80) != 0;
+    opcode_ = b0 & 0x0F;
+    payloadLen_ = len;
+    payloadRead_ = 0;
+    rsv_ = b0 & 0x70;
+    masked_ = masked;
+    return true;
+}
+
+FrameParser::Status FrameParser::next(Message& out) {
+    for (;;) {
+        if (!inFrame_) {
+            if (!parseHeader()) return Status::NeedMore;
+            if (!masked_) return fail(1002, "кадр клієнта без маски");
+            // RSV1 (0x40) — лише на першому кадрі даних і лише з permessage-deflate (RFC 7692 §6)
+            bool first = opcode_ == OpText || opcode_ == OpBinary;
+            uint8_t allowedRsv = compression_ && first ? 0x40 : 0;
+            if (rsv_ & ~allowedRsv) return fail(1002, "некоректний заголовок кадру (RSV)");
+
+            bool control = (opcode_ & 0x08) != 0;
+            if (control) {
+                if (!fin_ || payloadLen_ > kMaxControlPayload)
+                    return fail(1002, "фрагментований або завеликий керуючий кадр");
+                if (opcode_ != OpClose && opcode_ != OpPing && opcode_ != OpPong)
+                    return fail(1002, "невідомий керуючий opcode");
+            } else if (opcode_ == OpContinuation) {
+                if (!messageOpcode_) return fail(1002, "continuation без початкового кадру");
+            } else if (opcode_ == OpText || opcode_ == OpBinary) {
+                if (messageOpcode_) return fail(1002, "новий кадр до завершення фрагментованого");
+                messageOpcode_ = opcode_;
+                messageCompressed_ = (rsv_ & 0x40) != 0;
+                messageLen_ = 0;
+            } else {
+                return fail(1002, "невідомий opcode");
+            }
+            if (!control && payloadLen_ > maxMessageSize_ - messageLen_)
+                return fail(1009, "повідомлення перевищує ліміт");
+        }
+
+        bool control = (opcode_ & 0x08) != 0;
+        uint8_t* dst = control ? control_ : message_.get() + messageLen_;
+
+        // Переносимо доступну частину payload з кільцевого буфера і знімаємо маску на місці
+        while (payloadRead_ < payloadLen_ && input_.size() > 0) {
+            size_t chunk = 0;
+            const uint8_t* src = input_.readPtr(chunk);
+            chunk = static_cast<size_t>(std::min<uint64_t>(chunk, payloadLen_ - payloadRead_));
+            uint8_t* d = dst + payloadRead_;
+            std::memcpy(d, src, chunk);
+            unmask(d, chunk, mask_, payloadRead_);
+            input_.consume(chunk);
+            payloadRead_ += chunk;
+        }
+        if (payloadRead_ < payloadLen_) return Status::NeedMore;
+
+        inFrame_ = false;
+        if (control) {
+            if (opcode_ == OpClose && payloadLen_ > 0) {
+                if (payloadLen_ == 1) return fail(1002, "close з неповним кодом");
+                if (!isValidCloseCode(static_cast<uint16_t>((control_[0] << 8) | control_[1])))
+                    return fail(1002, "недопустимий код у close");
+            }
+            out.opcode = opcode_;
+            out.data = control_;
+            out.size = static_cast<size_t>(payloadLen_);
+            out.compressed = false;
+            return Status::Control;
+        }
+
+        messageLen_ += static_cast<size_t>(payloadLen_);
+        if (!fin_) continue;
+
+        out.opcode = messageOpcode_;
+        out.data = message_.get();
+        out.size = messageLen_;
+        out.compressed = messageCompressed_;
+        messageOpcode_ = 0;
+        messageLen_ = 0;
+        return Status::Message;
+    }
+}
+
+} // namespace ws
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ws {
+
+enum Opcode : uint8_t {
+    OpContinuation = 0x0,
+    OpText         = 0x1,
+    OpBinary       = 0x2,
+    OpClose        = 0x8,
+    OpPing         = 0x9,
+    OpPong         = 0xA
+};
+
+// Кільцевий буфер фіксованої ємності (степінь двійки) для сирих байтів із сокета.
+// Пам'ять виділяється один раз при створенні з'єднання.
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity);
+
+    size_t size() const { return static_cast<size_t>(tail_ - head_); }
+    size_t capacity() const { return mask_ + 1; }
+    bool full() const { return size() == capacity(); }
+
+    // Неперервна вільна ділянка для прямого recv() у буфер.
+    uint8_t* writePtr(size_t& contiguous);
+    void commit(size_t n) { tail_ += n; }
+
+    // Неперервна ділянка готових до читання байтів.
+    const uint8_t* readPtr(size_t& contiguous) const;
+    void consume(size_t n) { head_ += n; }
+
+    uint8_t peek(size_t offset) const { return buf_[(head_ + offset) & mask_]; }
+    void copyOut(uint8_t* dst, size_t n) const;
+
+private:
+    std::unique_ptr<uint8_t[]> buf_;
+    size_t mask_;
+    uint64_t head_ = 0;
+    uint64_t tail_ = 0;
+};
+
+// Інкрементальний розбір WebSocket-кадрів (RFC 6455) зі стану з'єднання.
+// Частково отримані заголовки лишаються в кільцевому буфері, частково
+// отримані payload — у буфері повідомлення, тож кадри можуть як злипатися,
+// так і розриватися між викликами recv(). Фрагментовані повідомлення
+// (opcode 0x0) збираються в один буфер; керуючі кадри між фрагментами
+// повертаються окремо і не псують збирання.
+class FrameParser {
+public:
+    enum class Status {
+        NeedMore,   // повного повідомлення ще немає
+        Message,    // зібране текстове/бінарне повідомлення
+        Control,    // керуючий кадр (close/ping/pong); close — порожній або з допустимим кодом
+        Error       // порушення протоколу, з'єднання слід закрити
+    };
+
+    struct Message {
+        uint8_t opcode;
+        const uint8_t* data;
+        size_t size;
+        bool compressed;  // RSV1 першого кадру: payload стиснутий permessage-deflate
+    };
+
+    static const size_t kDefaultInputSize = 4096;
+    static const size_t kDefaultMaxMessageSize = 64 * 1024;
+    static const size_t kMaxControlPayload = 125;
+
+    explicit FrameParser(size_t inputSize = kDefaultInputSize,
+                         size_t maxMessageSize = kDefaultMaxMessageSize);
+
+    RingBuffer& input() { return input_; }
+
+    // Дозволяє RSV1 на першому кадрі повідомлення (узгоджено permessage-deflate)
+    void setCompression(bool enabled) { compression_ = enabled; }
+
+    // Витягує наступне повідомлення з input(). Викликати, доки не поверне NeedMore.
+    // Дані у Message дійсні до наступного виклику next().
+    Status next(Message& out);
+
+    // Код закриття (RFC 6455 §7.4.1) для останньої помилки.
+    uint16_t errorCode() const { return errorCode_; }
+    const char* errorText() const { return errorText_; }
+
+private:
+    bool parseHeader();
+    Status fail(uint16_t code, const char* text);
+
+    RingBuffer input_;
+    std::unique_ptr<uint8_t[]> message_;
+    size_t maxMessageSize_;
+    size_t messageLen_ = 0;
+    uint8_t messageOpcode_ = 0;    // opcode першого фрагмента, 0 — немає незавершеного
+    bool messageCompressed_ = false;
+    bool compression_ = false;
+    uint8_t control_[kMaxControlPayload];
+
+    // Стан поточного кадру
+    bool inFrame_ = false;
+    bool fin_ = false;
+    bool masked_ = false;
+    uint8_t rsv_ = 0;
+    uint8_t opcode_ = 0;
+    uint8_t mask_[4] = {0, 0, 0, 0};
+    uint64_t payloadLen_ = 0;
+    uint64_t payloadRead_ = 0;
+
+    uint16_t errorCode_ = 0;
+    const char* errorText_ = "";
+};
+
+} // namespace ws
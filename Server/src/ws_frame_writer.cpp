@@ -0,0 +1,61 @@
+#include "ws_frame_writer.h"
+#include <cstring>
+
+namespace ws {
+
+namespace {
+
+const size_t kSmallPayload = 126;
+
+// Заздалегідь зібрані 2-байтові заголовки для коротких кадрів кожного opcode
+struct HeaderTemplates {
+    uint8_t bytes[16][kSmallPayload][2];
+
+    constexpr HeaderTemplates() : bytes() {
+        for (int op = 0; op < 16; op++) {
+            for (size_t len = 0; len < kSmallPayload; len++) {
+                bytes[op][len][0] = static_cast<uint8_t>(0x80 | op);
+                bytes[op][len][1] = static_cast<uint8_t>(len);
+            }
+        }
+    }
+};
+
+constexpr HeaderTemplates kHeaderTemplates;
+
+} // namespace
+
+size_t encodeHeader(uint8_t* out, Opcode opcode, uint64_t payloadSize) {
+    if (payloadSize < kSmallPayload) {
+        std::memcpy(out, kHeaderTemplates.bytes[opcode & 0x0F][payloadSize], 2);
+        return 2;
+    }
+    out[0] = static_cast<uint8_t>(0x80 | (opcode & 0x0F));
+    if (payloadSize <= 0xFFFF) {
+        out[1] = 126;
+        out[2] = static_cast<uint8_t>(payloadSize >> 8);
+        out[3] = static_cast<uint8_t>(payloadSize);
+        return 4;
+    }
+    out[1] = 127;
+    for (int i = 0; i < 8; i++)
+        out[2 + i] = static_cast<uint8_t>(payloadSize >> (56 - 8 * i));
+    return 10;
+}
+
+std::shared_ptr<const OutFrame> makeFrame(Opcode opcode, const void* data, size_t size) {
+    std::shared_ptr<OutFrame> frame = std::make_shared<OutFrame>();
+    frame->headerSize = static_cast<uint8_t>(encodeHeader(frame->header, opcode, size));
+    frame->payload.assign(static_cast<const char*>(data), size);
+    return frame;
+}
+
+std::shared_ptr<const OutFrame> makeFrame(Opcode opcode, std::string&& payload, bool compressed) {
+    std::shared_ptr<OutFrame> frame = std::make_shared<OutFrame>();
+    frame->headerSize = static_cast<uint8_t>(encodeHeader(frame->header, opcode, payload.size()));
+    if (compressed) frame->header[0] |= 0x40;
+    frame->payload = std::move(payload);
+    return frame;
+}
+
+} // namespace ws
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "ws_frame_parser.h"
+
+namespace ws {
+
+const size_t kMaxHeaderSize = 10;
+
+// Закодований кадр сервер -> клієнт (без маски, FIN=1). Після створення
+// не змінюється, тож один екземпляр можна ділити між кількома чергами
+// з'єднань (broadcast). Заголовок і payload лежать окремо і відправляються
+// одним gather-write.
+struct OutFrame {
+    uint8_t header[kMaxHeaderSize];
+    uint8_t headerSize;
+    std::string payload;
+
+    size_t size() const { return headerSize + payload.size(); }
+    Opcode opcode() const { return static_cast<Opcode>(header[0] & 0x0F); }
+    bool compressed() const { return (header[0] & 0x40) != 0; }
+};
+
+// Пише заголовок кадру в out (не менше kMaxHeaderSize байтів), повертає його довжину.
+// Для payload до 125 байтів копіює готовий шаблон.
+size_t encodeHeader(uint8_t* out, Opcode opcode, uint64_t payloadSize);
+
+std::shared_ptr<const OutFrame> makeFrame(Opcode opcode, const void* data, size_t size);
+// Кадр із уже готовим payload; compressed ставить RSV1 (permessage-deflate)
+std::shared_ptr<const OutFrame> makeFrame(Opcode opcode, std::string&& payload, bool compressed);
+
+} // namespace ws
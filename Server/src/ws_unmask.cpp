@@ -0,0 +1,168 @@
+#include "ws_unmask.h"
+#include <cstring>
+
+#if defined(WS_UNMASK_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+#if defined(WS_UNMASK_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WS_TARGET(t) __attribute__((target(t)))
+#else
+#define WS_TARGET(t)
+#endif
+
+namespace ws {
+namespace detail {
+
+namespace {
+
+inline uint8_t keyByte(uint32_t key, size_t i) {
+    uint8_t bytes[4];
+    std::memcpy(bytes, &key, 4);
+    return bytes[i & 3];
+}
+
+} // namespace
+
+void unmaskScalar(uint8_t* data, size_t len, uint32_t key) {
+    uint8_t k[4];
+    std::memcpy(k, &key, 4);
+    for (size_t i = 0; i < len; i++)
+        data[i] ^= k[i & 3];
+}
+
+void unmaskWord(uint8_t* data, size_t len, uint32_t key) {
+    uint64_t key64;
+    std::memcpy(&key64, &key, 4);
+    std::memcpy(reinterpret_cast<uint8_t*>(&key64) + 4, &key, 4);
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        w ^= key64;
+        std::memcpy(data + i, &w, 8);
+    }
+    for (; i < len; i++)
+        data[i] ^= keyByte(key, i);
+}
+
+#if defined(WS_UNMASK_X86)
+
+WS_TARGET("sse2")
+void unmaskSse2(uint8_t* data, size_t len, uint32_t key) {
+    const __m128i k = _mm_set1_epi32(static_cast<int>(key));
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), k));
+    }
+    unmaskWord(data + i, len - i, key);
+}
+
+WS_TARGET("avx2")
+void unmaskAvx2(uint8_t* data, size_t len, uint32_t key) {
+    const __m256i k = _mm256_set1_epi32(static_cast<int>(key));
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        __m256i* p0 = reinterpret_cast<__m256i*>(data + i);
+        __m256i* p1 = reinterpret_cast<__m256i*>(data + i + 32);
+        __m256i a = _mm256_loadu_si256(p0);
+        __m256i b = _mm256_loadu_si256(p1);
+        _mm256_storeu_si256(p0, _mm256_xor_si256(a, k));
+        _mm256_storeu_si256(p1, _mm256_xor_si256(b, k));
+    }
+    for (; i + 32 <= len; i += 32) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), k));
+    }
+    unmaskSse2(data + i, len - i, key);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuid(regs, 1);
+    bool osxsave = (regs[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+#if defined(WS_UNMASK_NEON)
+
+void unmaskNeon(uint8_t* data, size_t len, uint32_t key) {
+    const uint8x16_t k = vreinterpretq_u8_u32(vdupq_n_u32(key));
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        uint8x16_t a = vld1q_u8(data + i);
+        uint8x16_t b = vld1q_u8(data + i + 16);
+        vst1q_u8(data + i, veorq_u8(a, k));
+        vst1q_u8(data + i + 16, veorq_u8(b, k));
+    }
+    for (; i + 16 <= len; i += 16)
+        vst1q_u8(data + i, veorq_u8(vld1q_u8(data + i), k));
+    unmaskWord(data + i, len - i, key);
+}
+
+#endif
+
+} // namespace detail
+
+namespace {
+
+struct Backend {
+    detail::UnmaskFn fn;
+    const char* name;
+};
+
+Backend selectBackend() {
+#if defined(WS_UNMASK_X86)
+    if (detail::cpuHasAvx2()) return {detail::unmaskAvx2, "avx2"};
+    return {detail::unmaskSse2, "sse2"};
+#elif defined(WS_UNMASK_NEON)
+    return {detail::unmaskNeon, "neon"};
+#else
+    return {detail::unmaskWord, "word"};
+#endif
+}
+
+const Backend& backend() {
+    static const Backend b = selectBackend();
+    return b;
+}
+
+} // namespace
+
+void unmask(uint8_t* data, size_t len, const uint8_t mask[4], uint64_t phase) {
+    uint8_t rotated[4];
+    for (size_t i = 0; i < 4; i++)
+        rotated[i] = mask[(phase + i) & 3];
+    uint32_t key;
+    std::memcpy(&key, rotated, 4);
+    // Короткі керуючі команди ("left"/"right") не варті векторного шляху
+    if (len < 16) {
+        detail::unmaskScalar(data, len, key);
+        return;
+    }
+    backend().fn(data, len, key);
+}
+
+const char* unmaskBackendName() {
+    return backend().name;
+}
+
+} // namespace ws
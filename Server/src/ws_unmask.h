@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ws {
+
+// Знімає маску WebSocket in-place. phase — кількість байтів payload, уже
+// оброблених раніше (для кадрів, що надходять частинами). Реалізація
+// (скалярна, по словах, SSE2, AVX2 або NEON) обирається один раз під час
+// виконання за можливостями процесора.
+void unmask(uint8_t* data, size_t len, const uint8_t mask[4], uint64_t phase);
+
+const char* unmaskBackendName();
+
+// Окремі реалізації — для бенчмарків і перевірки на конкретній машині.
+namespace detail {
+
+using UnmaskFn = void (*)(uint8_t* data, size_t len, uint32_t key);
+
+// key — маска, вже зсунута на phase, у порядку байтів пам'яті.
+void unmaskScalar(uint8_t* data, size_t len, uint32_t key);
+void unmaskWord(uint8_t* data, size_t len, uint32_t key);
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define WS_UNMASK_X86 1
+void unmaskSse2(uint8_t* data, size_t len, uint32_t key);
+void unmaskAvx2(uint8_t* data, size_t len, uint32_t key);
+bool cpuHasAvx2();
+#endif
+#if defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define WS_UNMASK_NEON 1
+void unmaskNeon(uint8_t* data, size_t len, uint32_t key);
+#endif
+
+} // namespace detail
+} // namespace ws
@@ -0,0 +1,114 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include "websocket_server.h"
+
+// Тіл запитів сервер не читає, тож після запиту з тілом з'єднання має
+// закритися: інакше тіло (тут — вкладений GET) розбиралося б як наступний
+// запит. Кожен сценарій шле кілька запитів одним send() і рахує відповіді
+// до закриття з'єднання.
+
+namespace {
+
+const uint16_t kPort = 18769;
+
+int connectClient() {
+    for (int attempt = 0; attempt < 200; attempt++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(kPort);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0) {
+            struct timeval tv = {2, 0};
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+            return fd;
+        }
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return -1;
+}
+
+// Усе, що сервер відповів, доки не закрив з'єднання або не замовк на 2 с
+std::string exchange(const std::string& request) {
+    int fd = connectClient();
+    if (fd < 0) return std::string();
+    std::string out;
+    if (send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size())) {
+        char buf[4096];
+        ssize_t n;
+        while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) out.append(buf, static_cast<size_t>(n));
+    }
+    close(fd);
+    return out;
+}
+
+size_t countResponses(const std::string& out) {
+    size_t count = 0;
+    for (size_t pos = out.find("HTTP/1.1 "); pos != std::string::npos; pos = out.find("HTTP/1.1 ", pos + 1))
+        count++;
+    return count;
+}
+
+int failures = 0;
+
+void expect(bool ok, const char* what, const std::string& out) {
+    if (ok) return;
+    failures++;
+    std::fprintf(stderr, "FAIL: %s\n--- відповідь ---\n%s\n---\n", what, out.c_str());
+}
+
+} // namespace
+
+int main() {
+    char dir[] = "/tmp/remotecontrol_http_XXXXXX";
+    if (!mkdtemp(dir)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    std::string index = std::string(dir) + "/index.html";
+    std::ofstream(index) << "<!doctype html>\n";
+
+    WebSocketServer server(kPort);
+    server.setCompression(false);
+    if (!server.setWebRoot(dir)) {
+        std::fprintf(stderr, "setWebRoot(%s) не вдався\n", dir);
+        return 1;
+    }
+    server.start();
+
+    const std::string get = "GET /index.html HTTP/1.1\r\nHost: t\r\n\r\n";
+    const std::string smuggled = "GET /smuggled HTTP/1.1\r\nHost: t\r\n\r\n";
+
+    std::string out = exchange("POST / HTTP/1.1\r\nHost: t\r\nContent-Length: "
+                               + std::to_string(smuggled.size()) + "\r\n\r\n" + smuggled + get);
+    expect(countResponses(out) == 1 && out.compare(0, 12, "HTTP/1.1 405") == 0
+               && out.find("Connection: close\r\n") != std::string::npos,
+           "POST з тілом: одна відповідь 405 і закриття", out);
+
+    out = exchange("GET /index.html HTTP/1.1\r\nHost: t\r\nTransfer-Encoding: chunked\r\n\r\n"
+                   + std::to_string(smuggled.size()) + "\r\n" + smuggled + "\r\n0\r\n\r\n" + get);
+    expect(countResponses(out) == 1 && out.compare(0, 12, "HTTP/1.1 200") == 0
+               && out.find("Connection: close\r\n") != std::string::npos,
+           "GET з Transfer-Encoding: одна відповідь і закриття", out);
+
+    out = exchange("GET /index.html HTTP/1.1\r\nHost: t\r\nContent-Length: 0\r\n\r\n"
+                   "GET /index.html HTTP/1.1\r\nHost: t\r\nConnection: close\r\n\r\n");
+    expect(countResponses(out) == 2 && out.compare(0, 12, "HTTP/1.1 200") == 0,
+           "Content-Length: 0 не закриває з'єднання", out);
+
+    server.stop();
+    std::remove(index.c_str());
+    rmdir(dir);
+
+    if (failures == 0) std::printf("OK\n");
+    return failures == 0 ? 0 : 1;
+}